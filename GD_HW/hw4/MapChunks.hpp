@@ -0,0 +1,113 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "TextureAtlas.hpp"
+#include "TileMap.hpp"
+#include "TileMesh.hpp"
+
+constexpr int CHUNK_VERTICES = CHUNK_TILES * 4;
+
+/// chunks from first to last, both included, empty when a first is past its last
+struct ChunkRange {
+	int firstRow, lastRow;
+	int firstCol, lastCol;
+
+	[[nodiscard]] bool isEmpty() const { return firstRow > lastRow || firstCol > lastCol; }
+
+	[[nodiscard]] int getCount() const { return isEmpty() ? 0 : (lastRow - firstRow + 1) * (lastCol - firstCol + 1); }
+};
+
+/// chunks an ortho view of halfWidth by halfHeight can show. the view is turned a quarter, so the screen
+/// height runs along the rows, and it is centered where the map is moved by (midCol, midRow).
+/// a tile of margin covers the quad size and the odd row pad
+inline ChunkRange visibleChunks(int chunkRows, int chunkCols, float midRow, float midCol, float halfWidth, float halfHeight) {
+	float firstRow = (midRow - halfHeight) / 0.75f - 1, lastRow = (midRow + halfHeight) / 0.75f + 1;
+	float firstCol = midCol - halfWidth - 1, lastCol = midCol + halfWidth + 1;
+	return ChunkRange{
+			std::max(0, (int) std::floor(firstRow / CHUNK_SIZE)), std::min(chunkRows - 1, (int) std::floor(lastRow / CHUNK_SIZE)),
+			std::max(0, (int) std::floor(firstCol / CHUNK_SIZE)), std::min(chunkCols - 1, (int) std::floor(lastCol / CHUNK_SIZE)),
+	};
+}
+
+/// vertex buffers of the chunks drawn last, built from the map when they come into view.
+/// every chunk has all CHUNK_TILES quads, tiles past the map edge have no size, so a tile is always
+/// at the same vertex. when full, the least recently drawn chunk gives up its buffer, so memory
+/// follows the capacity and not the map size.
+class ChunkCache {
+public:
+	explicit ChunkCache(int capacity = 128) : capacity(capacity) {}
+
+	/// buffer of CHUNK_VERTICES tile vertices, positions are from the chunk corner
+	unsigned int get(const TileMap &map, const TextureAtlas &atlas, int chunkRow, int chunkCol) {
+		auto key = ((int64_t) chunkRow << 32) | (uint32_t) chunkCol;
+		auto found = index.find(key);
+		if (found != index.end()) {
+			chunks.splice(chunks.begin(), chunks, found->second);
+			return found->second->buffer;
+		}
+
+		unsigned int buffer = 0;
+		if ((int) chunks.size() >= capacity) {
+			auto &last = chunks.back();
+			buffer = last.buffer;
+			index.erase(((int64_t) last.row << 32) | (uint32_t) last.col);
+			chunks.pop_back();
+		} else {
+			glGenBuffers(1, &buffer);
+		}
+		build(map, atlas, chunkRow, chunkCol, buffer);
+		chunks.push_front(Chunk{chunkRow, chunkCol, buffer});
+		index[key] = chunks.begin();
+		misses++;
+		return buffer;
+	}
+
+	void clear() {
+		for (auto &chunk : chunks) glDeleteBuffers(1, &chunk.buffer);
+		chunks.clear();
+		index.clear();
+	}
+
+	[[nodiscard]] int getSize() const { return (int) chunks.size(); }
+
+	/// chunks read and built since the start
+	[[nodiscard]] long getMissCount() const { return misses; }
+
+private:
+	struct Chunk {
+		int row, col;
+		unsigned int buffer;
+	};
+
+	void build(const TileMap &map, const TextureAtlas &atlas, int chunkRow, int chunkCol, unsigned int buffer) {
+		auto page = map.getChunk(chunkRow, chunkCol);
+		vertices.clear();
+		for (int row = 0; row < CHUNK_SIZE; row++) {
+			for (int col = 0; col < CHUNK_SIZE; col++) {
+				int tile = page[row * CHUNK_SIZE + col];
+				if (tile < atlas.getRegionCount())
+					appendTile(vertices, col, row, atlas.getRegion(tile));
+				else
+					appendTile(vertices, col, row, AtlasRegion{}, 0);
+			}
+		}
+
+		glBindBuffer(GL_ARRAY_BUFFER, buffer);
+		glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr) (vertices.size() * sizeof(TileVertex)), vertices.data(), GL_STATIC_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	const int capacity;
+	std::list<Chunk> chunks; // most recently drawn first
+	std::unordered_map<int64_t, std::list<Chunk>::iterator> index;
+	long misses = 0;
+
+	std::vector<TileVertex> vertices; // scratch of the chunk being built
+};
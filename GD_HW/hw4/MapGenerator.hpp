@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+#include "TileMap.hpp"
+
+/// the tile of a place for a seed, the same whatever order a map is filled in
+inline uint8_t randomTile(uint32_t seed, int col, int row, int types) {
+	// splitmix64 of the place mixed with the seed
+	uint64_t x = (((uint64_t) (uint32_t) row << 32) | (uint32_t) col) + (uint64_t) seed * 0x9E3779B97F4A7C15ull;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+	x ^= x >> 31;
+	return (uint8_t) (x % (uint64_t) types);
+}
+
+/// fills a map made in memory with uniform tiles of types kinds, a chunk at a time
+inline void generateMap(TileMap &map, int types, uint32_t seed) {
+	for (int chunkRow = 0; chunkRow < map.getChunkRows(); chunkRow++) {
+		for (int chunkCol = 0; chunkCol < map.getChunkCols(); chunkCol++) {
+			auto tiles = map.editChunk(chunkRow, chunkCol);
+			for (int y = 0; y < CHUNK_SIZE; y++) {
+				int row = chunkRow * CHUNK_SIZE + y;
+				for (int x = 0; x < CHUNK_SIZE; x++) {
+					int col = chunkCol * CHUNK_SIZE + x;
+					if (row < map.getRows() && col < map.getCols())
+						tiles[y * CHUNK_SIZE + x] = randomTile(seed, col, row, types);
+				}
+			}
+		}
+	}
+}
@@ -2,41 +2,48 @@
 #include <GL/glut.h>
 #include <glm/glm.hpp>
 #include <SOIL/SOIL.h>
+#include <cstddef>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "MapChunks.hpp"
+#include "TextureAtlas.hpp"
+#include "TileMap.hpp"
+#include "TileMesh.hpp"
+
 class Renderer {
 public:
-	explicit Renderer(std::vector<const char *> tiles_path, std::vector<std::vector<unsigned int>> tiles_map)
+	explicit Renderer(std::vector<const char *> tiles_path, std::string map_path)
 			: tiles_path(std::move(tiles_path)),
-				tiles_map(std::move(tiles_map)) {}
+				map_path(std::move(map_path)) {}
 
-	void init() {
-		initTextures();
+	/// returns false if the map file can not be read or the tiles do not fit one texture
+	bool init() {
+		if (!map.load(map_path) || !initTextures()) return false;
 		glEnable(GL_DEPTH_TEST);
+		return true;
 	}
 
 	void resize(int w, int h) {
 		glViewport(0, 0, w, h);
 	}
 
-	void initTextures() {
+	bool initTextures() {
 		glEnable(GL_BLEND);
 		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-		tiles_texture.clear();
+		// a tile that can not be read is drawn plain white, like a texture SOIL failed on
+		const unsigned char white[] = {255, 255, 255, 255};
 		for (const auto &path : tiles_path) {
-			unsigned int terrain = SOIL_load_OGL_texture(
-					path,
-					SOIL_LOAD_RGBA,
-					SOIL_CREATE_NEW_ID,
-					0//SOIL_FLAG_INVERT_Y
-			);
-			tiles_texture.push_back(terrain);
+			if (atlas.load(path) < 0)
+				atlas.add(white, 1, 1);
 		}
+		if (atlas.build() == 0) return false;
 
-		midRow = 1.0f * (float) (tiles_map.size() / 2);
-		midCol = 1.0f * (float) (tiles_map.size() / 2);
+		midRow = 1.0f * (float) (map.getRows() / 2);
+		midCol = 1.0f * (float) (map.getCols() / 2);
+		return true;
 	}
 
 	void display() {
@@ -55,62 +62,75 @@ public:
 		gluLookAt(+0, +0, +10, 0, 0, 0, 1, 0, 0);
 		glTranslatef(0, 0, 0);
 
-		drawMap();
+		drawMap(s * r, s);
 	}
 
-	void drawMap() {
+	/// draws the chunks the view of halfWidth by halfHeight can show, one call each
+	void drawMap(float halfWidth, float halfHeight) {
 		glMatrixMode(GL_MODELVIEW);
 		glLoadIdentity();
-		for (int row = 0; row < tiles_map.size(); row++) {
-			for (int col = 0; col < tiles_map[row].size(); col++) {
-				unsigned int tile = tiles_map[row][col];
-				// std::cout << tile << " ";
-				drawTileAt(col, row, tile);
-			}
-			// std::cout << std::endl;
-		}
-		// std::cout << std::endl;
-	}
-
-	void drawTileAt(float col, float row, unsigned int tile) {
-		float oddPad = (float) ((int) row & 1) * 0.5f;
-		float xPos = col * -1.0f + oddPad;
-		float yPos = row * -0.75f;
-		float zPos = (1000 * row + col) * 0.0001f;
+		auto range = visibleChunks(map.getChunkRows(), map.getChunkCols(), midRow, midCol, halfWidth, halfHeight);
+		if (range.isEmpty()) return;
 
 		glPushMatrix();
 		glRotatef(90, 0, 0, 1);
-		glTranslatef(midCol + xPos, midRow + yPos, zPos);
-		if (selectCol == col && selectRow == row)
-			glScalef(0.9, 0.9, 0.9);
-		drawTerrian(tile);
-		glPopMatrix();
+		glTranslatef(midCol, midRow, 0);
 
-	}
-
-	void drawTerrian(unsigned int tileType) {
 		glEnable(GL_TEXTURE_2D);
-		glBindTexture(GL_TEXTURE_2D, tiles_texture[tileType]);
-
-		glBegin(GL_QUADS);
-
-		glColor4f(1.0f, 1.0f, 1.0, 1.0f);
-		glTexCoord2f(0.0f, 0.0f);
-		glVertex2f(-0.5f, -0.5f);
-
-		glTexCoord2f(1.0f, 0.0f);
-		glVertex2f(0.5f, -0.5f);
-
-		glTexCoord2f(1.0f, 1.0f);
-		glVertex2f(0.5f, 0.5f);
-
-		glTexCoord2f(0.0f, 1.0f);
-		glVertex2f(-0.5f, 0.5f);
+		glBindTexture(GL_TEXTURE_2D, atlas.getTexture());
+		glEnableClientState(GL_VERTEX_ARRAY);
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+
+		for (int chunkRow = range.firstRow; chunkRow <= range.lastRow; chunkRow++) {
+			for (int chunkCol = range.firstCol; chunkCol <= range.lastCol; chunkCol++) {
+				glBindBuffer(GL_ARRAY_BUFFER, chunks.get(map, atlas, chunkRow, chunkCol));
+				glVertexPointer(3, GL_FLOAT, sizeof(TileVertex), (void *) offsetof(TileVertex, x));
+				glTexCoordPointer(2, GL_FLOAT, sizeof(TileVertex), (void *) offsetof(TileVertex, u));
+
+				// depth is counted from the first chunk in view, so it stays in range on any map size
+				glPushMatrix();
+				glTranslatef((float) (chunkCol * CHUNK_SIZE) * -1.0f, (float) (chunkRow * CHUNK_SIZE) * -0.75f,
+				             (float) ((chunkRow - range.firstRow) * CHUNK_SIZE) * ROW_DEPTH +
+				             (float) ((chunkCol - range.firstCol) * CHUNK_SIZE) * COL_DEPTH);
+
+				// the selected tile is left out of the chunk call and drawn again smaller
+				int selected = selectedVertex(chunkRow, chunkCol);
+				if (selected < 0) {
+					glDrawArrays(GL_QUADS, 0, CHUNK_VERTICES);
+				} else {
+					const GLint first[] = {0, selected + 4};
+					const GLsizei count[] = {selected, CHUNK_VERTICES - selected - 4};
+					glMultiDrawArrays(GL_QUADS, first, count, 2);
+					drawSelected(selected);
+				}
+				glPopMatrix();
+			}
+		}
 
-		glEnd();
+		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+		glDisableClientState(GL_VERTEX_ARRAY);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
 		glDisable(GL_TEXTURE_2D);
+		glPopMatrix();
 	}
 
+	/// first vertex of the selected tile in the buffer of a chunk, -1 if it is not in that chunk
+	[[nodiscard]] int selectedVertex(int chunkRow, int chunkCol) const {
+		if (selectRow < 0 || selectRow >= map.getRows() || selectCol < 0 || selectCol >= map.getCols()) return -1;
+		if (selectRow / CHUNK_SIZE != chunkRow || selectCol / CHUNK_SIZE != chunkCol) return -1;
+		return ((selectRow % CHUNK_SIZE) * CHUNK_SIZE + selectCol % CHUNK_SIZE) * 4;
+	}
+
+	void drawSelected(int first) {
+		auto center = tileCenter(selectCol % CHUNK_SIZE, selectRow % CHUNK_SIZE);
+		glPushMatrix();
+		glTranslatef(center.x, center.y, center.z);
+		glScalef(0.9, 0.9, 0.9);
+		glTranslatef(-center.x, -center.y, -center.z);
+		glDrawArrays(GL_QUADS, first, 4);
+		glPopMatrix();
+	}
 
 	void mouse(int button, int state, int x, int y) {
 		if (button == GLUT_LEFT_BUTTON) {
@@ -203,8 +223,10 @@ public:
 private:
 
 	const std::vector<const char *> tiles_path;
-	const std::vector<std::vector<unsigned int>> tiles_map;
-	std::vector<unsigned int> tiles_texture;
+	const std::string map_path;
+	TileMap map; // mapped from map_path
+	TextureAtlas atlas;
+	ChunkCache chunks;
 
 	int selectCol = 2, selectRow = 2;
 	float midRow = 0, midCol = 0, zoom = 0.5, speed = 0.3;
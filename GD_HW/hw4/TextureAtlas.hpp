@@ -0,0 +1,108 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <SOIL/SOIL.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+/// where an image sits in the atlas, in texture coordinates
+struct AtlasRegion {
+	float u0, v0, u1, v1;
+};
+
+/// tile images side by side in one RGBA texture, so the whole map needs a single bind.
+/// a clear gap is left around every image so a neighbour never shows at a tile edge.
+class TextureAtlas {
+public:
+	static constexpr int GAP = 2;
+
+	/// reads an image with SOIL and places it, returns its region or -1 if it could not be read
+	int load(const char *path) {
+		int width, height, channels;
+		unsigned char *pixels = SOIL_load_image(path, &width, &height, &channels, SOIL_LOAD_RGBA);
+		if (pixels == nullptr) return -1;
+		int index = add(pixels, width, height);
+		SOIL_free_image_data(pixels);
+		return index;
+	}
+
+	/// places RGBA pixels, top row first like SOIL gives them, returns the region index
+	int add(const unsigned char *pixels, int width, int height) {
+		images.push_back(Image{std::vector<unsigned char>(pixels, pixels + (size_t) width * height * 4), width, height});
+		return (int) images.size() - 1;
+	}
+
+	/// packs the images in rows no wider than the largest texture GL takes, or than maxSize when it is
+	/// given, uploads them as one texture and frees the copies. returns 0 and uploads nothing if they do not fit
+	unsigned int build(int maxSize = 0) {
+		if (maxSize <= 0) glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+
+		// each image goes after the last one, or at the start of a new row below when the row is full
+		std::vector<int> xs, ys;
+		int x = GAP, y = GAP, rowHeight = 0;
+		width = GAP;
+		for (const auto &image : images) {
+			if (x > GAP && x + image.width + GAP > maxSize) {
+				x = GAP;
+				y += rowHeight + GAP;
+				rowHeight = 0;
+			}
+			xs.push_back(x);
+			ys.push_back(y);
+			x += image.width + GAP;
+			rowHeight = std::max(rowHeight, image.height);
+			width = std::max(width, x);
+		}
+		height = y + rowHeight + GAP;
+		if (width > maxSize || height > maxSize) {
+			fprintf(stderr, "Error: tiles need a %dx%d atlas, GL takes up to %d\n", width, height, maxSize);
+			return 0;
+		}
+
+		std::vector<unsigned char> pixels((size_t) width * height * 4, 0);
+		regions.clear();
+		for (size_t i = 0; i < images.size(); i++) {
+			const auto &image = images[i];
+			for (int row = 0; row < image.height; row++)
+				std::memcpy(&pixels[((size_t) (ys[i] + row) * width + xs[i]) * 4],
+				            &image.pixels[(size_t) row * image.width * 4],
+				            (size_t) image.width * 4);
+			regions.push_back(AtlasRegion{
+					(float) xs[i] / (float) width, (float) ys[i] / (float) height,
+					(float) (xs[i] + image.width) / (float) width, (float) (ys[i] + image.height) / (float) height,
+			});
+		}
+		images.clear();
+		images.shrink_to_fit();
+
+		// nearest and clamped like SOIL_load_OGL_texture without mipmaps
+		if (texture == 0) glGenTextures(1, &texture);
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+		glBindTexture(GL_TEXTURE_2D, 0);
+		return texture;
+	}
+
+	[[nodiscard]] const AtlasRegion &getRegion(int index) const { return regions[index]; }
+
+	[[nodiscard]] int getRegionCount() const { return (int) regions.size(); }
+
+	[[nodiscard]] unsigned int getTexture() const { return texture; }
+
+private:
+	struct Image {
+		std::vector<unsigned char> pixels;
+		int width, height;
+	};
+
+	std::vector<Image> images; // waiting for build
+	std::vector<AtlasRegion> regions;
+	unsigned int texture = 0;
+	int width = 0, height = 0;
+};
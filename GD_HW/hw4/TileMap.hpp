@@ -0,0 +1,178 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+/// tiles per side of a chunk, even so a chunk starts on an even row like the map
+constexpr int CHUNK_SIZE = 32;
+constexpr int CHUNK_TILES = CHUNK_SIZE * CHUNK_SIZE;
+
+/// id of the tiles a chunk has past the map edge
+constexpr uint8_t EMPTY_TILE = 255;
+
+/// on disk layout of a tile map, the header then the tiles exactly as TileMap keeps them in memory.
+/// numbers are little endian.
+struct MapFileHeader {
+	char magic[4]; // "HKTM"
+	uint32_t version;
+	uint32_t rows;
+	uint32_t cols;
+	uint32_t chunkSize;
+	uint32_t reserved;
+	uint64_t fileSize;
+	uint64_t pages; // uint8[chunkRows * chunkCols * CHUNK_TILES]
+};
+
+/// one byte tile ids in a single flat array, chunk by chunk and rows first in a chunk, so a chunk is
+/// CHUNK_TILES bytes in a row. a map is either made in memory or mapped read only from a file, a
+/// mapped map only costs the pages that are read. views of a mapped map must not outlive it.
+class TileMap {
+public:
+	static const uint32_t VERSION = 1;
+
+	TileMap() = default;
+
+	TileMap(const TileMap &) = delete;
+
+	TileMap &operator=(const TileMap &) = delete;
+
+	~TileMap() { unload(); }
+
+	/// a rows x cols map in memory, every tile 0
+	void create(int rows, int cols) {
+		unload();
+		this->rows = rows;
+		this->cols = cols;
+		this->tiles.assign((size_t) getChunkRows() * getChunkCols() * CHUNK_TILES, EMPTY_TILE);
+		for (int row = 0; row < rows; row++)
+			for (int col = 0; col < cols; col++)
+				this->tiles[indexOf(col, row)] = 0;
+		this->pages = this->tiles.data();
+	}
+
+	/// writes next to path and renames over it, so a mapped older version stays valid.
+	/// returns false if the file could not be written
+	bool save(const std::string &path) const {
+		MapFileHeader header{};
+		std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+		header.version = VERSION;
+		header.rows = this->rows;
+		header.cols = this->cols;
+		header.chunkSize = CHUNK_SIZE;
+		header.pages = sizeof(MapFileHeader);
+		header.fileSize = header.pages + getByteCount();
+
+		auto temporary = path + ".tmp";
+		auto file = std::fopen(temporary.c_str(), "wb");
+		if (file == nullptr) return false;
+		bool written = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+		               std::fwrite(this->pages, 1, getByteCount(), file) == getByteCount();
+		written = std::fclose(file) == 0 && written;
+
+		if (!written || std::rename(temporary.c_str(), path.c_str()) != 0) {
+			std::remove(temporary.c_str());
+			return false;
+		}
+		return true;
+	}
+
+	/// maps path, returns false if it is missing, truncated or of another version
+	bool load(const std::string &path) {
+		unload();
+
+		int file = open(path.c_str(), O_RDONLY);
+		if (file < 0) return false;
+
+		struct stat status{};
+		void *mapping = MAP_FAILED;
+		if (fstat(file, &status) == 0 && status.st_size >= (off_t) sizeof(MapFileHeader))
+			mapping = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+		close(file);
+		if (mapping == MAP_FAILED) return false;
+
+		this->data = (const uint8_t *) mapping;
+		this->size = status.st_size;
+		if (!validate()) {
+			unload();
+			return false;
+		}
+		auto &header = *(const MapFileHeader *) this->data;
+		this->rows = (int) header.rows;
+		this->cols = (int) header.cols;
+		this->pages = this->data + header.pages;
+		return true;
+	}
+
+	void unload() {
+		if (this->data != nullptr) munmap((void *) this->data, this->size);
+		this->data = nullptr;
+		this->size = 0;
+		this->tiles.clear();
+		this->tiles.shrink_to_fit();
+		this->pages = nullptr;
+		this->rows = this->cols = 0;
+	}
+
+	[[nodiscard]] bool isLoaded() const { return this->pages != nullptr; }
+
+	[[nodiscard]] uint8_t getTile(int col, int row) const { return this->pages[indexOf(col, row)]; }
+
+	/// only for a map made in memory
+	void setTile(int col, int row, uint8_t tile) { this->tiles[indexOf(col, row)] = tile; }
+
+	/// the CHUNK_TILES ids of a chunk, rows first
+	[[nodiscard]] const uint8_t *getChunk(int chunkRow, int chunkCol) const {
+		return this->pages + ((size_t) chunkRow * getChunkCols() + chunkCol) * CHUNK_TILES;
+	}
+
+	/// only for a map made in memory
+	[[nodiscard]] uint8_t *editChunk(int chunkRow, int chunkCol) {
+		return this->tiles.data() + ((size_t) chunkRow * getChunkCols() + chunkCol) * CHUNK_TILES;
+	}
+
+	[[nodiscard]] int getRows() const { return this->rows; }
+
+	[[nodiscard]] int getCols() const { return this->cols; }
+
+	[[nodiscard]] int getChunkRows() const { return (this->rows + CHUNK_SIZE - 1) / CHUNK_SIZE; }
+
+	[[nodiscard]] int getChunkCols() const { return (this->cols + CHUNK_SIZE - 1) / CHUNK_SIZE; }
+
+	/// bytes of tile ids, chunks past the edge included
+	[[nodiscard]] size_t getByteCount() const { return (size_t) getChunkRows() * getChunkCols() * CHUNK_TILES; }
+
+private:
+	static constexpr char MAGIC[4] = {'H', 'K', 'T', 'M'};
+
+	[[nodiscard]] size_t indexOf(int col, int row) const {
+		return ((size_t) (row / CHUNK_SIZE) * getChunkCols() + col / CHUNK_SIZE) * CHUNK_TILES +
+		       (row % CHUNK_SIZE) * CHUNK_SIZE + col % CHUNK_SIZE;
+	}
+
+	[[nodiscard]] bool validate() const {
+		auto &header = *(const MapFileHeader *) this->data;
+		if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) return false;
+		if (header.version != VERSION || header.chunkSize != CHUNK_SIZE || header.fileSize != this->size) return false;
+		if (header.rows == 0 || header.cols == 0 || header.rows > INT32_MAX / 2 || header.cols > INT32_MAX / 2) return false;
+		const uint64_t chunkRows = (header.rows + CHUNK_SIZE - 1) / CHUNK_SIZE;
+		const uint64_t chunkCols = (header.cols + CHUNK_SIZE - 1) / CHUNK_SIZE;
+		return header.pages >= sizeof(MapFileHeader) && header.pages <= this->size &&
+		       chunkRows * chunkCols * CHUNK_TILES == this->size - header.pages;
+	}
+
+	int rows = 0, cols = 0;
+	const uint8_t *pages = nullptr; // the tiles or the mapping past the header
+
+	std::vector<uint8_t> tiles; // when made in memory
+
+	// the file mapping when loaded
+	const uint8_t *data = nullptr;
+	size_t size = 0;
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "TextureAtlas.hpp"
+
+/// a corner of a tile quad, map space before the view is moved and turned, and its place in the atlas
+struct TileVertex {
+	float x, y, z;
+	float u, v;
+};
+
+/// later rows and columns come a little closer to the camera so they overlap the earlier ones
+constexpr float ROW_DEPTH = 0.1f;
+constexpr float COL_DEPTH = 0.0001f;
+
+/// center of a tile, odd rows are pushed half a tile to fit the hex edges
+inline glm::vec3 tileCenter(int col, int row) {
+	float oddPad = (float) (row & 1) * 0.5f;
+	return {(float) col * -1.0f + oddPad, (float) row * -0.75f, (float) row * ROW_DEPTH + (float) col * COL_DEPTH};
+}
+
+/// the four corners of a tile quad, in GL_QUADS order. a tile of size 0 draws nothing but keeps the
+/// places of the tiles after it
+inline void appendTile(std::vector<TileVertex> &vertices, int col, int row, const AtlasRegion &region, float size = 1) {
+	auto c = tileCenter(col, row);
+	float h = size / 2;
+	vertices.push_back(TileVertex{c.x - h, c.y - h, c.z, region.u0, region.v0});
+	vertices.push_back(TileVertex{c.x + h, c.y - h, c.z, region.u1, region.v0});
+	vertices.push_back(TileVertex{c.x + h, c.y + h, c.z, region.u1, region.v1});
+	vertices.push_back(TileVertex{c.x - h, c.y + h, c.z, region.u0, region.v1});
+}
@@ -0,0 +1,44 @@
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#include "MapGenerator.hpp"
+#include "TileMap.hpp"
+
+// Headless map maker for hw04-map, no window or GL needed
+// usage: hw04-map-generator file rows cols [seed [types]]
+// output: rows;cols;seed;types;tile_bytes;generate_ms;save_ms
+
+int main(int argc, char **argv) {
+	if (argc < 4) {
+		fprintf(stderr, "usage: %s file rows cols [seed [types]]\n", argv[0]);
+		return 1;
+	}
+	const std::string path = argv[1];
+	const int rows = std::stoi(argv[2]);
+	const int cols = std::stoi(argv[3]);
+	const uint32_t seed = argc > 4 ? (uint32_t) std::stoul(argv[4]) : 1399;
+	const int types = argc > 5 ? std::stoi(argv[5]) : 7;
+	if (rows <= 0 || cols <= 0 || types <= 0 || types >= EMPTY_TILE) {
+		fprintf(stderr, "Error: rows, cols and types must be positive and types below %d\n", EMPTY_TILE);
+		return 1;
+	}
+
+	auto start = std::chrono::high_resolution_clock::now();
+	TileMap map;
+	map.create(rows, cols);
+	generateMap(map, types, seed);
+	auto generated = std::chrono::high_resolution_clock::now();
+	if (!map.save(path)) {
+		fprintf(stderr, "Error: can not write %s\n", path.c_str());
+		return 1;
+	}
+	auto saved = std::chrono::high_resolution_clock::now();
+
+	std::cout << "rows;cols;seed;types;tile_bytes;generate_ms;save_ms" << std::endl;
+	std::cout << rows << ";" << cols << ";" << seed << ";" << types << ";" << map.getByteCount() << ";"
+	          << std::chrono::duration<double, std::milli>(generated - start).count() << ";"
+	          << std::chrono::duration<double, std::milli>(saved - generated).count() << std::endl;
+	return 0;
+}
@@ -1,4 +1,5 @@
 #include "Renderer.cpp"
+#include "MapGenerator.hpp"
 
 
 static Renderer *renderer;
@@ -29,6 +30,20 @@ static void glutMotion(int x, int y) {
 }
 
 int main(int argc, char **argv) {
+	// usage: hw04-map [map file [rows cols]], the map is made first when it is missing or a size is given
+	if (argc == 3 || argc > 4) {
+		fprintf(stderr, "usage: %s [map file [rows cols]]\n", argv[0]);
+		return 1;
+	}
+	const std::string map_path = argc > 1 ? argv[1] : "hw04-map.hktm";
+	const int rows = argc > 3 ? std::stoi(argv[2]) : 100;
+	const int cols = argc > 3 ? std::stoi(argv[3]) : 100;
+	if (rows <= 0 || cols <= 0) {
+		fprintf(stderr, "Error: rows and cols must be positive\n");
+		fprintf(stderr, "usage: %s [map file [rows cols]]\n", argv[0]);
+		return 1;
+	}
+
 	glutInit(&argc, argv);
 	glutInitDisplayMode(GLUT_DEPTH | GLUT_DOUBLE | GLUT_RGBA | GLUT_MULTISAMPLE);
 	glEnable(GL_MULTISAMPLE);
@@ -37,6 +52,7 @@ int main(int argc, char **argv) {
 	glutInitWindowPosition(100, 100);
 	glutInitWindowSize(800, 800);
 	glutCreateWindow("WindowTitle");
+	glewInit();
 
 	glutDisplayFunc(glutDisplay);
 	glutReshapeFunc(glutResize);
@@ -59,27 +75,21 @@ int main(int argc, char **argv) {
 			"../assets/western_watertower.png",//6
 	};
 
-	//std::vector<std::vector<unsigned int>> tiles_map(5, std::vector<unsigned int>(5, 1));
-
-	std::vector<std::vector<unsigned int>> tiles_map(100, std::vector<unsigned int>(100, 0));
-	for (auto &row : tiles_map) {
-		for (unsigned int &cell : row) {
-			cell = random() * 1000 % tiles_path.size();
+	if (argc > 3 || !TileMap().load(map_path)) {
+		TileMap generated;
+		generated.create(rows, cols);
+		generateMap(generated, (int) tiles_path.size(), 1399);
+		if (!generated.save(map_path)) {
+			fprintf(stderr, "Error: can not write %s\n", map_path.c_str());
+			return 1;
 		}
 	}
 
-//	const std::vector<std::vector<unsigned int>> tiles_map{
-////			{0},
-////			{1},
-////			{2},
-////			{3},
-//			{3, 4, 5},
-//			{0, 1, 2, 3, 4, 5, 6},
-//			{1, 2},
-//	};
-
-	renderer = new Renderer(tiles_path, tiles_map);
-	renderer->init();
+	renderer = new Renderer(tiles_path, map_path);
+	if (!renderer->init()) {
+		fprintf(stderr, "Error: can not show %s\n", map_path.c_str());
+		return 1;
+	}
 
 	glutMainLoop();
 
@@ -0,0 +1,178 @@
+#include <algorithm>
+#include <cmath>
+#include "AnimationClip.h"
+
+static const float QUAT_RANGE = 0.70710678f; // no component but the largest can be above 1/sqrt(2)
+static const float QUAT_SCALE = 32767.0f;
+
+PackedQuat PackedQuat::pack(const glm::quat &quat) {
+	auto q = glm::normalize(quat);
+	float c[4] = {q.x, q.y, q.z, q.w};
+
+	int largest = 0;
+	for (int i = 1; i < 4; i++)
+		if (std::fabs(c[i]) > std::fabs(c[largest])) largest = i;
+
+	// q and -q are the same rotation, keep the dropped component positive
+	float sign = c[largest] < 0 ? -1.0f : 1.0f;
+
+	uint16_t small[3];
+	for (int i = 0, j = 0; i < 4; i++) {
+		if (i == largest) continue;
+		float v = std::clamp(sign * c[i] / QUAT_RANGE, -1.0f, 1.0f);
+		small[j++] = (uint16_t) std::lround((v * 0.5f + 0.5f) * QUAT_SCALE);
+	}
+
+	return PackedQuat{{
+			(uint16_t) (((largest >> 1) << 15) | small[0]),
+			(uint16_t) (((largest & 1) << 15) | small[1]),
+			small[2],
+	}};
+}
+
+glm::quat PackedQuat::unpack() const {
+	const float scale = 2 * QUAT_RANGE / QUAT_SCALE;
+	float a = float(this->data[0] & 0x7FFF) * scale - QUAT_RANGE;
+	float b = float(this->data[1] & 0x7FFF) * scale - QUAT_RANGE;
+	float c = float(this->data[2] & 0x7FFF) * scale - QUAT_RANGE;
+	float d = std::sqrt(std::max(0.0f, 1 - a * a - b * b - c * c));
+
+	// the three stored components keep their x, y, z, w order around the dropped one
+	switch (((this->data[0] >> 15) << 1) | (this->data[1] >> 15)) {
+		case 0: return glm::quat(c, d, a, b);
+		case 1: return glm::quat(c, a, d, b);
+		case 2: return glm::quat(c, a, b, d);
+		default: return glm::quat(d, a, b, c);
+	}
+}
+
+template<class Key>
+void Track<Key>::setKey(float time, const Key &key) {
+	auto it = std::lower_bound(this->times.begin(), this->times.end(), time);
+	auto index = it - this->times.begin();
+	if (it != this->times.end() && *it == time) {
+		this->keys[index] = key;
+	} else {
+		this->times.insert(it, time);
+		this->keys.insert(this->keys.begin() + index, key);
+	}
+}
+
+template<class Key>
+int Track<Key>::find(float time, int cursor) const {
+	const int n = (int) this->times.size();
+	auto covers = [&](int k) {
+		return k >= -1 && k < n && (k < 0 || this->times[k] <= time) && (k + 1 >= n || time < this->times[k + 1]);
+	};
+
+	// playback moves forward, so the key is nearly always the cached one or the next
+	if (covers(cursor)) return cursor;
+	if (covers(cursor + 1)) return cursor + 1;
+
+	return int(std::upper_bound(this->times.begin(), this->times.end(), time) - this->times.begin()) - 1;
+}
+
+void AnimationClip::setRotationKey(int bone, float time, const glm::quat &rotation) {
+	reserveBone(bone);
+	this->rotations[bone].setKey(wrap(time), PackedQuat::pack(rotation));
+}
+
+void AnimationClip::setTranslationKey(int bone, float time, const glm::vec3 &translation) {
+	reserveBone(bone);
+	this->translations[bone].setKey(wrap(time), translation);
+}
+
+void AnimationClip::setRotationTrack(int bone, const float *times, const PackedQuat *keys, int count) {
+	reserveBone(bone);
+	this->rotations[bone].times.assign(times, times + count);
+	this->rotations[bone].keys.assign(keys, keys + count);
+}
+
+void AnimationClip::setTranslationTrack(int bone, const float *times, const glm::vec3 *keys, int count) {
+	reserveBone(bone);
+	this->translations[bone].times.assign(times, times + count);
+	this->translations[bone].keys.assign(keys, keys + count);
+}
+
+void AnimationClip::reserveBone(int bone) {
+	if (bone < getBoneCount()) return;
+	this->rotations.resize(bone + 1);
+	this->translations.resize(bone + 1);
+}
+
+float AnimationClip::wrap(float time) const {
+	time = std::fmod(time, this->duration);
+	return time < 0 ? time + this->duration : time;
+}
+
+template<class Key>
+bool AnimationClip::locate(const Track<Key> &track, float time, int &cursor, int &from, int &to, float &u) const {
+	const int n = (int) track.times.size();
+	if (n == 0) return false;
+
+	cursor = track.find(time, cursor);
+
+	// before the first or after the last key the clip blends across its loop point
+	from = cursor < 0 ? n - 1 : cursor;
+	to = from + 1 < n ? from + 1 : 0;
+
+	float fromTime = track.times[from];
+	float toTime = track.times[to];
+	if (cursor < 0) fromTime -= this->duration;
+	else if (to <= from) toTime += this->duration;
+
+	u = toTime > fromTime ? (time - fromTime) / (toTime - fromTime) : 0;
+	return true;
+}
+
+void AnimationClip::sampleBone(int bone, float time, ClipCursor &cursor, glm::quat &rotation, glm::vec3 &translation) const {
+	rotation = glm::quat(1, 0, 0, 0);
+	translation = glm::vec3(0);
+	if (bone >= getBoneCount()) return;
+
+	int from, to;
+	float u;
+
+	auto &rotationTrack = this->rotations[bone];
+	if (locate(rotationTrack, time, cursor.rotation[bone], from, to, u))
+		rotation = blendQuat(rotationTrack.keys[from].unpack(), rotationTrack.keys[to].unpack(), u);
+
+	auto &translationTrack = this->translations[bone];
+	if (locate(translationTrack, time, cursor.translation[bone], from, to, u))
+		translation = translationTrack.keys[from] + (translationTrack.keys[to] - translationTrack.keys[from]) * u;
+}
+
+void AnimationClip::sample(float time, ClipCursor &cursor, Pose &pose) const {
+	cursor.rotation.resize(getBoneCount(), -1);
+	cursor.translation.resize(getBoneCount(), -1);
+	time = wrap(time);
+
+	glm::quat rotation;
+	glm::vec3 translation;
+	for (int i = 0; i < pose.getBoneCount(); i++) {
+		sampleBone(i, time, cursor, rotation, translation);
+		pose.setTransform(i, rotation, translation);
+	}
+}
+
+void AnimationClip::sample(float time, ClipCursor &cursor, PoseBuffer &buffer) const {
+	cursor.rotation.resize(getBoneCount(), -1);
+	cursor.translation.resize(getBoneCount(), -1);
+	time = wrap(time);
+
+	glm::quat rotation;
+	glm::vec3 translation;
+	for (int i = 0; i < buffer.getBoneCount(); i++) {
+		sampleBone(i, time, cursor, rotation, translation);
+		buffer.set(i, rotation, translation);
+	}
+}
+
+size_t AnimationClip::getMemorySize() const {
+	size_t size = 0;
+	for (auto &track : this->rotations)
+		size += track.times.size() * (sizeof(float) + sizeof(PackedQuat));
+	for (auto &track : this->translations)
+		size += track.times.size() * (sizeof(float) + sizeof(glm::vec3));
+	return size;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "Pose.h"
+#include "PoseBuffer.h"
+
+/// unit quaternion in 48 bits, smallest three encoding:
+/// the largest component is dropped and rebuilt from the other three, which are stored as 15 bit fixed point.
+/// the two high bits of data[0] and data[1] hold the index of the dropped component.
+struct PackedQuat {
+	uint16_t data[3];
+
+	static PackedQuat pack(const glm::quat &quat);
+
+	[[nodiscard]] glm::quat unpack() const;
+};
+
+/// keys of one channel of one bone, sorted by time
+template<class Key>
+struct Track {
+	std::vector<float> times;
+	std::vector<Key> keys;
+
+	/// replaces the key at exactly this time or inserts a new one
+	void setKey(float time, const Key &key);
+
+	/// index of the last key at or before time, -1 if time is before the first key.
+	/// cursor is the result of the previous call, a forward step from it is checked before the binary search
+	[[nodiscard]] int find(float time, int cursor) const;
+};
+
+/// per instance sampling state of a clip, the last key index of every track
+struct ClipCursor {
+	std::vector<int> rotation;
+	std::vector<int> translation;
+};
+
+/// looping animation with per bone rotation and translation tracks at arbitrary key times.
+/// rotations are stored as PackedQuat, a bone with no key in a channel keeps the identity there.
+/// tracks grow with the highest keyed bone, so a clip can be recorded before the rig is complete.
+class AnimationClip {
+public:
+
+	explicit AnimationClip(float duration) : duration(duration) {}
+
+	[[nodiscard]] inline int getBoneCount() const { return (int) this->rotations.size(); }
+
+	[[nodiscard]] inline float getDuration() const { return this->duration; }
+
+	void setRotationKey(int bone, float time, const glm::quat &rotation);
+
+	void setTranslationKey(int bone, float time, const glm::vec3 &translation);
+
+	[[nodiscard]] inline const Track<PackedQuat> &getRotationTrack(int bone) const { return this->rotations[bone]; }
+
+	[[nodiscard]] inline const Track<glm::vec3> &getTranslationTrack(int bone) const { return this->translations[bone]; }
+
+	/// replaces a whole track in one copy, times must be sorted and inside the clip, for loading code
+	void setRotationTrack(int bone, const float *times, const PackedQuat *keys, int count);
+
+	void setTranslationTrack(int bone, const float *times, const glm::vec3 *keys, int count);
+
+	/// writes the local transform of every bone at `time` into pose
+	void sample(float time, ClipCursor &cursor, Pose &pose) const;
+
+	void sample(float time, ClipCursor &cursor, PoseBuffer &buffer) const;
+
+	/// bytes of key data, to compare against other key layouts
+	[[nodiscard]] size_t getMemorySize() const;
+
+private:
+
+	void reserveBone(int bone);
+
+	/// time must already be wrapped
+	void sampleBone(int bone, float time, ClipCursor &cursor, glm::quat &rotation, glm::vec3 &translation) const;
+
+	/// wraps time into [0, duration)
+	[[nodiscard]] float wrap(float time) const;
+
+	/// finds the two keys around time, looping over the clip end, and the blend factor between them
+	template<class Key>
+	bool locate(const Track<Key> &track, float time, int &cursor, int &from, int &to, float &u) const;
+
+	std::vector<Track<PackedQuat> > rotations;
+	std::vector<Track<glm::vec3> > translations;
+	float duration;
+};
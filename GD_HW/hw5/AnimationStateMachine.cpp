@@ -0,0 +1,90 @@
+#include <algorithm>
+#include "AnimationStateMachine.h"
+
+AnimationStateMachine::AnimationStateMachine(int boneCount)
+		: result(boneCount), previousBuffer(boneCount), layerBuffer(boneCount) {}
+
+int AnimationStateMachine::AddState(const std::string &name, const AnimationClip *clip) {
+	this->states.push_back(State{name, clip});
+	return (int) this->states.size() - 1;
+}
+
+int AnimationStateMachine::AddAction(const std::string &name) {
+	this->actions.push_back(name);
+	return (int) this->actions.size() - 1;
+}
+
+void AnimationStateMachine::AddTransition(int from, int action, int to, float fadeTime) {
+	this->transitions.push_back(Transition{from, action, to, fadeTime});
+}
+
+int AnimationStateMachine::FindAction(const std::string &name) const {
+	auto it = std::find(this->actions.begin(), this->actions.end(), name);
+	return it == this->actions.end() ? -1 : int(it - this->actions.begin());
+}
+
+bool AnimationStateMachine::Trigger(int action) {
+	for (auto &transition : this->transitions) {
+		if (transition.from != this->state || transition.action != action) continue;
+
+		this->previousState = this->state;
+		this->previousTime = this->time;
+		std::swap(this->previousCursor, this->cursor);
+
+		this->state = transition.to;
+		this->time = 0;
+		this->fadeTime = 0;
+		this->fadeDuration = transition.fadeTime;
+		return true;
+	}
+	return false;
+}
+
+int AnimationStateMachine::AddLayer(const AnimationClip *clip, const std::vector<float> &mask, bool additive) {
+	this->layers.push_back(Layer{clip, mask, additive, 1, 0, ClipCursor()});
+	auto &layerMask = this->layers.back().mask;
+	if (!layerMask.empty()) layerMask.resize(this->result.getBoneCount(), 0);
+	return (int) this->layers.size() - 1;
+}
+
+void AnimationStateMachine::SetLayerWeight(int layer, float weight) {
+	this->layers[layer].weight = weight;
+}
+
+void AnimationStateMachine::SetTime(float newTime) {
+	this->time = newTime;
+}
+
+void AnimationStateMachine::Update(float deltaTime) {
+	this->time += deltaTime;
+	this->previousTime += deltaTime;
+	this->fadeTime = std::min(this->fadeTime + deltaTime, this->fadeDuration);
+	for (auto &layer : this->layers) layer.time += deltaTime;
+}
+
+void AnimationStateMachine::Sample(const AnimationClip *clip, float time, ClipCursor &cursor, PoseBuffer &buffer) {
+	if (clip == nullptr) buffer.setIdentity();
+	else clip->sample(time, cursor, buffer);
+}
+
+void AnimationStateMachine::Evaluate(Pose &pose) {
+	if (this->states.empty()) return;
+
+	Sample(this->states[this->state].clip, this->time, this->cursor, this->result);
+
+	if (IsFading()) {
+		Sample(this->states[this->previousState].clip, this->previousTime, this->previousCursor, this->previousBuffer);
+		PoseBuffer::blend(this->previousBuffer, this->result, this->fadeTime / this->fadeDuration, nullptr, this->result);
+	}
+
+	for (auto &layer : this->layers) {
+		if (layer.weight <= 0) continue;
+		Sample(layer.clip, layer.time, layer.cursor, this->layerBuffer);
+
+		const float *mask = layer.mask.empty() ? nullptr : layer.mask.data();
+		if (layer.additive) PoseBuffer::add(this->result, this->layerBuffer, layer.weight, mask, this->result);
+		else PoseBuffer::blend(this->result, this->layerBuffer, layer.weight, mask, this->result);
+	}
+
+	this->result.apply(pose);
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "AnimationClip.h"
+#include "PoseBuffer.h"
+
+/// animation state machine in the shape of Project/StateMachine.py:
+/// named states and actions with a transition table, where each state plays a clip
+/// and a transition cross-fades from the old state to the new one.
+/// on top of the state, layers blend or add further clips, limited to the bones of their mask.
+/// every clip is sampled once per Evaluate into preallocated pose buffers.
+class AnimationStateMachine {
+public:
+
+	explicit AnimationStateMachine(int boneCount);
+
+	/// clip may be null for the rest pose, returns the state index
+	int AddState(const std::string &name, const AnimationClip *clip);
+
+	/// returns the action index
+	int AddAction(const std::string &name);
+
+	void AddTransition(int from, int action, int to, float fadeTime);
+
+	/// -1 when there is no such action
+	[[nodiscard]] int FindAction(const std::string &name) const;
+
+	/// follows the transition of the current state for this action, false if there is none
+	bool Trigger(int action);
+
+	/// override layers replace the bones in their mask, additive layers add the clip on top of them.
+	/// mask holds one weight per bone, an empty mask covers every bone. returns the layer index
+	int AddLayer(const AnimationClip *clip, const std::vector<float> &mask, bool additive);
+
+	void SetLayerWeight(int layer, float weight);
+
+	/// jumps the current state to this time
+	void SetTime(float time);
+
+	void Update(float deltaTime);
+
+	/// writes the blended locals into pose, the global pose still needs calc_Mi_a
+	void Evaluate(Pose &pose);
+
+	[[nodiscard]] inline int GetState() const { return this->state; }
+
+	[[nodiscard]] inline const std::string &GetStateName() const { return this->states[this->state].name; }
+
+	[[nodiscard]] inline bool IsFading() const { return this->fadeTime < this->fadeDuration; }
+
+private:
+
+	struct State {
+		std::string name;
+		const AnimationClip *clip;
+	};
+
+	struct Transition {
+		int from;
+		int action;
+		int to;
+		float fadeTime;
+	};
+
+	struct Layer {
+		const AnimationClip *clip;
+		std::vector<float> mask;
+		bool additive;
+		float weight;
+		float time;
+		ClipCursor cursor;
+	};
+
+	static void Sample(const AnimationClip *clip, float time, ClipCursor &cursor, PoseBuffer &buffer);
+
+	std::vector<State> states;
+	std::vector<std::string> actions;
+	std::vector<Transition> transitions;
+	std::vector<Layer> layers;
+
+	int state = 0;
+	float time = 0;
+	ClipCursor cursor;
+
+	// state we fade out of
+	int previousState = 0;
+	float previousTime = 0;
+	ClipCursor previousCursor;
+	float fadeTime = 0;
+	float fadeDuration = 0;
+
+	PoseBuffer result;
+	PoseBuffer previousBuffer;
+	PoseBuffer layerBuffer;
+};
@@ -0,0 +1,788 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <chrono>
+#include <filesystem>
+#include <random>
+#include <map>
+#include <vector>
+#include <sys/resource.h>
+
+#include "AnimationStateMachine.h"
+#include "Crowd.h"
+#include "IKBatch.h"
+#include "IKSolver.h"
+#include "RigAsset.h"
+#include "Scene.h"
+#include "Skeleton.h"
+#include "Skinning.h"
+#include "ThreadPool.h"
+
+// Headless benchmark for the hw5 kinematics, no window or GL needed
+// output: stage;count;threads;ms_per_frame;count_per_ms
+// count is vertices for skinning stages and instances for crowd stages
+// usage: hw05-kinematic-bench [depth branching vertices frames]
+// with arguments only the scene stages run, on a synthetic rig of that shape
+
+// every allocation of the process, so the scene stages can report allocations per frame
+static std::atomic<long> allocationCount{0};
+
+void *operator new(std::size_t size) {
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+	if (void *memory = std::malloc(size > 0 ? size : 1)) return memory;
+	throw std::bad_alloc();
+}
+
+// out of line, gcc otherwise inlines the free next to its own new and warns about a mismatch
+[[gnu::noinline]] void operator delete(void *memory) noexcept { std::free(memory); }
+
+[[gnu::noinline]] void operator delete(void *memory, std::size_t) noexcept { std::free(memory); }
+
+namespace KinematicBench {
+	const int BONE_COUNT = 9;
+	const int BONE_LENGTH = 15;
+	const int CROWD_SKIN_SIZE = 500;
+
+	// the vertex Scene used to keep, bind pose, two bones and skinned output in one struct
+	struct Vertex {
+		float orig_x;
+		float orig_y;
+		int bone_1;
+		int bone_2;
+		float weigth_1;
+		float weigth_2;
+		float x;
+		float y;
+	};
+
+	Skeleton *CreateSkeleton() {
+		auto skeleton = new Skeleton();
+		int parent = -1;
+		for (int i = 0; i < BONE_COUNT; i++) {
+			auto bone = skeleton->addBone(parent, "Bone " + std::to_string(i + 1), BONE_LENGTH, glm::vec3(), glm::vec3());
+			parent = bone;
+		}
+		skeleton->calc_Mi_d();
+		return skeleton;
+	}
+
+	std::vector<Vertex> CreateSkin(int vertexCount, std::mt19937 &random) {
+		std::uniform_int_distribution<int> bone(0, BONE_COUNT - 2);
+		std::uniform_real_distribution<float> along(0, BONE_LENGTH);
+		std::uniform_real_distribution<float> side(-5, 5);
+		std::uniform_real_distribution<float> weight(0, 1);
+
+		std::vector<Vertex> skin;
+		for (int i = 0; i < vertexCount; i++) {
+			auto b = bone(random);
+			auto w = weight(random);
+			skin.push_back(Vertex{float(b * BONE_LENGTH) + along(random), side(random), b, b + 1, w, 1 - w, 0, 0});
+		}
+		return skin;
+	}
+
+	SkinnedMesh CreateMesh(const std::vector<Vertex> &skin) {
+		SkinnedMesh mesh;
+		for (auto &vert : skin)
+			mesh.addVertex(glm::vec2(vert.orig_x, vert.orig_y), {{vert.bone_1, vert.weigth_1}, {vert.bone_2, vert.weigth_2}});
+		return mesh;
+	}
+
+	// every vertex spread over the four bones around it, mesh vertices ordered along the chain
+	SkinnedMesh CreateMesh4(int vertexCount, std::mt19937 &random) {
+		std::uniform_real_distribution<float> side(-5, 5);
+		std::uniform_real_distribution<float> weight(0, 1);
+
+		SkinnedMesh mesh;
+		for (int i = 0; i < vertexCount; i++) {
+			auto along = float(i) / float(vertexCount) * float((BONE_COUNT - 3) * BONE_LENGTH);
+			auto b = int(along) / BONE_LENGTH;
+			mesh.addVertex(glm::vec2(along, side(random)), {
+					{b, weight(random)}, {b + 1, weight(random)}, {b + 2, weight(random)}, {b + 3, weight(random)}
+			});
+		}
+		return mesh;
+	}
+
+	std::vector<std::map<int, glm::quat> > CreateKeyframes(int keyframeCount, std::mt19937 &random) {
+		std::uniform_real_distribution<float> angle(-0.5f, 0.5f);
+
+		std::vector<std::map<int, glm::quat> > keyframes(keyframeCount);
+		for (auto &keyframe : keyframes)
+			for (int i = 0; i < BONE_COUNT; i++)
+				keyframe[i] = glm::angleAxis(angle(random), glm::vec3(0, 0, 1));
+		return keyframes;
+	}
+
+	AnimationClip CreateClip(const std::vector<std::map<int, glm::quat> > &keyframes) {
+		AnimationClip clip((float) keyframes.size());
+		for (int frame = 0; frame < (int) keyframes.size(); frame++)
+			for (auto &[bone, quat] : keyframes[frame])
+				clip.setRotationKey(bone, float(frame), quat);
+		return clip;
+	}
+
+	// what Scene::Animate used to do, a map lookup per bone per keyframe and uniform one second keys
+	void MapSample(std::vector<std::map<int, glm::quat> > &keyframes, float time, Pose &pose) {
+		const int keyframeCount = (int) keyframes.size();
+		float progress = time - float(int(time));
+		auto &startFrame = keyframes[int(time) % keyframeCount];
+		auto &endFrame = keyframes[(int(time) + 1) % keyframeCount];
+
+		auto defaultQuat = glm::quat_cast(glm::identity<glm::mat4>());
+		for (auto i = 0; i < pose.getBoneCount(); i++) {
+			auto startQuat = startFrame.contains(i) ? startFrame[i] : defaultQuat;
+			auto endQuat = endFrame.contains(i) ? endFrame[i] : defaultQuat;
+			pose.getBone(i).setQuat(glm::slerp(startQuat, endQuat, progress));
+		}
+	}
+
+	void SetPose(Pose &pose, int frame) {
+		for (int i = 0; i < pose.getBoneCount(); i++)
+			pose.getBone(i).rotate(glm::vec3(0, 0, 0.01f * float(frame % 100) * float(i % 3 - 1)));
+		pose.calc_Mi_a();
+	}
+
+	// what Scene::Update used to do, every vertex asks both bones for a full 4x4 transform
+	void PerVertexSkin(Pose &pose, std::vector<Vertex> &skin) {
+		for (Vertex &vert : skin) {
+			auto orig_pos = glm::vec3(vert.orig_x, vert.orig_y, 1);
+			auto pos1 = pose.getBone(vert.bone_1).transform(orig_pos);
+			auto pos2 = pose.getBone(vert.bone_2).transform(orig_pos);
+			vert.x = pos1.x * vert.weigth_1 + pos2.x * vert.weigth_2;
+			vert.y = pos1.y * vert.weigth_1 + pos2.y * vert.weigth_2;
+		}
+	}
+
+	template<class Fn>
+	void Measure(const char *stage, int count, int threads, int frames, Fn fn) {
+		auto start = std::chrono::high_resolution_clock::now();
+		for (int frame = 0; frame < frames; frame++) fn(frame);
+		auto stop = std::chrono::high_resolution_clock::now();
+		auto ms = std::chrono::duration<double, std::milli>(stop - start).count() / frames;
+		std::cout << stage << ";" << count << ";" << threads << ";" << ms << ";" << count / ms << std::endl;
+	}
+
+	void SkinningBench(ThreadPool &pool) {
+		std::mt19937 random(1399);
+		auto skeleton = CreateSkeleton();
+		Pose pose(skeleton);
+
+		for (int vertexCount : {1000, 10000, 100000, 1000000}) {
+			auto skin = CreateSkin(vertexCount, random);
+			int frames = std::max(10, 10000000 / vertexCount);
+
+			auto mesh = CreateMesh(skin);
+			Skinning skinning;
+			skinning.setMesh(mesh.getView());
+
+			Measure("skin-per-vertex", vertexCount, 1, frames, [&](int frame) {
+				SetPose(pose, frame);
+				PerVertexSkin(pose, skin);
+			});
+
+			Measure("skin-batched", vertexCount, 1, frames, [&](int frame) {
+				SetPose(pose, frame);
+				skinning.updateMatrices(pose);
+				skinning.skin(nullptr);
+				pose.clearMoved();
+			});
+
+			Measure("skin-batched", vertexCount, pool.getThreadCount(), frames, [&](int frame) {
+				SetPose(pose, frame);
+				skinning.updateMatrices(pose);
+				skinning.skin(&pool);
+				pose.clearMoved();
+			});
+
+			auto mesh4 = CreateMesh4(vertexCount, random);
+			Skinning skinning4;
+			skinning4.setMesh(mesh4.getView());
+
+			Measure("skin-batched-4-bones", vertexCount, 1, frames, [&](int frame) {
+				SetPose(pose, frame);
+				skinning4.updateMatrices(pose);
+				skinning4.skin(nullptr);
+				pose.clearMoved();
+			});
+		}
+	}
+
+	// Scene::Update on a mostly static rig, only changed subtrees and the vertices they move are redone
+	void DirtyBench() {
+		const int vertexCount = 100000;
+		const int frames = 200;
+		std::mt19937 random(1399);
+		auto skeleton = CreateSkeleton();
+		Pose pose(skeleton);
+
+		// vertices of a real mesh come grouped by the bone they sit on
+		auto skin = CreateSkin(vertexCount, random);
+		std::sort(skin.begin(), skin.end(), [](const Vertex &a, const Vertex &b) { return a.orig_x < b.orig_x; });
+
+		auto mesh = CreateMesh(skin);
+		Skinning skinning;
+		skinning.setMesh(mesh.getView());
+
+		auto update = [&]() {
+			pose.calc_Mi_a();
+			skinning.updateMatrices(pose);
+			skinning.skin(nullptr);
+			pose.clearMoved();
+		};
+		update();
+
+		Measure("update-all-bones", vertexCount, 1, frames, [&](int frame) {
+			for (int i = 0; i < BONE_COUNT; i++)
+				pose.getBone(i).setQuat(glm::angleAxis(0.001f * float(frame + i), glm::vec3(0, 0, 1)));
+			update();
+		});
+
+		Measure("update-last-bone", vertexCount, 1, frames, [&](int frame) {
+			pose.getBone(BONE_COUNT - 1).setQuat(glm::angleAxis(0.001f * float(frame), glm::vec3(0, 0, 1)));
+			update();
+		});
+
+		Measure("update-idle", vertexCount, 1, frames, [&](int) {
+			update();
+		});
+	}
+
+	// what a bone update used to cost, three mat4 rotations for a z angle and a quaternion taken back out of the matrix
+	void MatrixRotate(glm::mat4 &Mi_l, glm::quat &quat, glm::vec3 theta) {
+		Mi_l = glm::identity<glm::mat4>();
+		Mi_l = glm::rotate(Mi_l, theta.z, glm::vec3(0, 0, 1));
+		Mi_l = glm::rotate(Mi_l, theta.y, glm::vec3(0, 1, 0));
+		Mi_l = glm::rotate(Mi_l, theta.x, glm::vec3(1, 0, 0));
+		quat = glm::quat_cast(Mi_l);
+	}
+
+	// and setting a blended quaternion went to a matrix and back again
+	void MatrixSetQuat(glm::mat4 &Mi_l, glm::quat &quat, const glm::quat &newQuat) {
+		Mi_l = glm::toMat4(newQuat);
+		quat = glm::quat_cast(Mi_l);
+	}
+
+	void BoneUpdateBench() {
+		std::mt19937 random(1399);
+		auto skeleton = CreateSkeleton();
+		auto keyframes = CreateKeyframes(2, random);
+
+		const int poseCount = 1000;
+		const int boneUpdates = poseCount * BONE_COUNT;
+		std::vector<Pose> poses(poseCount, Pose(skeleton));
+		std::vector<glm::mat4> locals(boneUpdates);
+		std::vector<glm::quat> quats(boneUpdates);
+
+		Measure("bone-rotate-mat4", boneUpdates, 1, 200, [&](int frame) {
+			for (int i = 0; i < boneUpdates; i++)
+				MatrixRotate(locals[i], quats[i], glm::vec3(0, 0, 0.001f * float(frame + i)));
+		});
+
+		Measure("bone-rotate-quat", boneUpdates, 1, 200, [&](int frame) {
+			for (int i = 0; i < boneUpdates; i++)
+				poses[i / BONE_COUNT].getBone(i % BONE_COUNT).rotate(glm::vec3(0, 0, 0.001f * float(frame + i)));
+		});
+
+		Measure("bone-blend-mat4", boneUpdates, 1, 200, [&](int frame) {
+			float u = float(frame % 60) / 60;
+			for (int i = 0; i < boneUpdates; i++) {
+				int bone = i % BONE_COUNT;
+				MatrixSetQuat(locals[i], quats[i], glm::slerp(keyframes[0][bone], keyframes[1][bone], u));
+			}
+		});
+
+		Measure("bone-blend-quat", boneUpdates, 1, 200, [&](int frame) {
+			float u = float(frame % 60) / 60;
+			for (int i = 0; i < boneUpdates; i++) {
+				int bone = i % BONE_COUNT;
+				poses[i / BONE_COUNT].setQuat(bone, blendQuat(keyframes[0][bone], keyframes[1][bone], u));
+			}
+		});
+	}
+
+	void ClipBench() {
+		std::mt19937 random(1399);
+		auto skeleton = CreateSkeleton();
+		auto keyframes = CreateKeyframes(KEYFRAME_COUNT, random);
+		auto clip = CreateClip(keyframes);
+
+		const int poseCount = 1000;
+		std::vector<Pose> poses(poseCount, Pose(skeleton));
+		std::vector<ClipCursor> cursors(poseCount);
+
+		Measure("sample-keyframe-map", poseCount, 1, 200, [&](int frame) {
+			for (int i = 0; i < poseCount; i++)
+				MapSample(keyframes, float(i % KEYFRAME_COUNT) + float(frame) / 60, poses[i]);
+		});
+
+		Measure("sample-clip", poseCount, 1, 200, [&](int frame) {
+			for (int i = 0; i < poseCount; i++)
+				clip.sample(float(i % KEYFRAME_COUNT) + float(frame) / 60, cursors[i], poses[i]);
+		});
+	}
+
+	void ClipMemory() {
+		std::mt19937 random(1399);
+		auto keyframes = CreateKeyframes(KEYFRAME_COUNT, random);
+		auto clip = CreateClip(keyframes);
+
+		// a map node holds the value next to three links and a color word
+		size_t mapSize = keyframes.size() * sizeof(std::map<int, glm::quat>);
+		for (auto &keyframe : keyframes)
+			mapSize += keyframe.size() * (sizeof(std::pair<const int, glm::quat>) + 4 * sizeof(void *));
+
+		std::cout << "layout;keys;bytes" << std::endl;
+		std::cout << "keyframe-map;" << KEYFRAME_COUNT * BONE_COUNT << ";" << mapSize << std::endl;
+		std::cout << "clip;" << KEYFRAME_COUNT * BONE_COUNT << ";" << clip.getMemorySize() << std::endl;
+	}
+
+	void MeshMemory() {
+		const int vertexCount = 10000;
+		std::mt19937 random(1399);
+		auto skin = CreateSkin(vertexCount, random);
+		auto mesh = CreateMesh(skin);
+
+		std::cout << "layout;vertices;bytes" << std::endl;
+		std::cout << "vertex-struct;" << vertexCount << ";" << skin.size() * sizeof(Vertex) << std::endl;
+		std::cout << "skinned-mesh;" << vertexCount << ";" << mesh.getMemorySize() << std::endl;
+	}
+
+	void AnimatorBench() {
+		std::mt19937 random(1399);
+		auto skeleton = CreateSkeleton();
+		auto walk = CreateClip(CreateKeyframes(KEYFRAME_COUNT, random));
+		auto run = CreateClip(CreateKeyframes(KEYFRAME_COUNT, random));
+		auto wave = CreateClip(CreateKeyframes(KEYFRAME_COUNT, random));
+
+		// upper half of the chain only
+		std::vector<float> mask(BONE_COUNT, 0);
+		for (int i = BONE_COUNT / 2; i < BONE_COUNT; i++) mask[i] = 1;
+
+		const int characterCount = 1000;
+		std::vector<Pose> poses(characterCount, Pose(skeleton));
+		std::vector<AnimationStateMachine> animators(characterCount, AnimationStateMachine(BONE_COUNT));
+		for (auto &animator : animators) {
+			int walkState = animator.AddState("Walk", &walk);
+			int runState = animator.AddState("Run", &run);
+			int faster = animator.AddAction("faster");
+			int slower = animator.AddAction("slower");
+			animator.AddTransition(walkState, faster, runState, 0.5f);
+			animator.AddTransition(runState, slower, walkState, 0.5f);
+			animator.AddLayer(&wave, mask, true);
+		}
+
+		Measure("animator-evaluate", characterCount, 1, 200, [&](int frame) {
+			for (int i = 0; i < characterCount; i++) {
+				auto &animator = animators[i];
+				// keep about half of the characters in a cross-fade
+				if ((frame + i) % 40 == 0) animator.Trigger(animator.GetState() == 0 ? 1 : 0);
+				animator.Update(1.0f / 60);
+				animator.Evaluate(poses[i]);
+				poses[i].calc_Mi_a();
+			}
+		});
+	}
+
+	// what Scene::InverseKinematic used to do, ten CCD rounds over the whole chain,
+	// returns the first round that got within tolerance or the round count if none did
+	int CcdSolve(Pose &pose, glm::vec2 target2, float tolerance) {
+		const auto target = glm::vec3(target2, 0);
+		Bone endEffector = pose.getBone(pose.getBoneCount() - 1);
+		int reachedAt = 0;
+
+		for (int round = 1; round <= 10; round++) {
+			for (Bone startBone = endEffector; startBone.isValid(); startBone = startBone.getParent()) {
+				auto startBonePos = startBone.transform_from_boneSpace(glm::vec3(0, 0, 0));
+				auto endEffectorPos = endEffector.transform_from_boneSpace(glm::vec3(endEffector.getLength(), 0, 0));
+				if (endEffectorPos.x == target.x && endEffectorPos.y == target.y) return round;
+
+				glm::vec3 U = endEffectorPos - startBonePos;
+				glm::vec3 F = target - endEffectorPos;
+				glm::vec3 G = target - startBonePos;
+				auto u = glm::length(U);
+				auto f = glm::length(F);
+				auto g = glm::length(G);
+				auto tetha = glm::acos((u * u + g * g - f * f) / (2 * u * g));
+
+				float UdotG = U.x * -G.y + U.y * G.x;
+				float newAngle = startBone.getAngle();
+				if (UdotG > 0) newAngle -= tetha;
+				else if (UdotG < 0) newAngle += tetha;
+
+				if (!std::isnan(newAngle) && !std::isnan(tetha) && glm::abs(tetha) > 0.001) {
+					startBone.rotate(glm::vec3(0, 0, newAngle));
+					startBone.calc_Mi_a();
+				}
+			}
+
+			auto end = endEffector.transform_from_boneSpace(glm::vec3(endEffector.getLength(), 0, 0));
+			if (reachedAt == 0 && glm::length(glm::vec2(end) - target2) <= tolerance) reachedAt = round;
+		}
+		return reachedAt == 0 ? 10 : reachedAt;
+	}
+
+	void IKBench() {
+		std::mt19937 random(1399);
+		auto skeleton = CreateSkeleton();
+		auto chain = IKChain::fromSkeleton(*skeleton, BONE_COUNT - 1);
+		Pose pose(skeleton);
+
+		// targets from random poses, so every one is reachable
+		const int targetCount = 2000;
+		std::uniform_real_distribution<float> angle(-0.6f, 0.6f);
+		std::vector<glm::vec2> targets;
+		for (int i = 0; i < targetCount; i++) {
+			for (int j = 0; j < BONE_COUNT; j++) pose.getBone(j).rotate(glm::vec3(0, 0, angle(random)));
+			pose.calc_Mi_a();
+			targets.emplace_back(pose.getBone(BONE_COUNT - 1).transform_from_boneSpace(glm::vec3(BONE_LENGTH, 0, 0)));
+		}
+
+		FabrikSolver fabrik;
+		DlsSolver dls;
+		const float tolerance = fabrik.tolerance;
+
+		std::cout << "solver;targets;avg_iterations;us_per_solve;reached" << std::endl;
+		auto report = [&](const char *solver, auto solveOne) {
+			long iterations = 0;
+			int reached = 0;
+			auto start = std::chrono::high_resolution_clock::now();
+			for (auto &target : targets) {
+				pose.reset();
+				pose.calc_Mi_a();
+				iterations += solveOne(target, reached);
+			}
+			auto stop = std::chrono::high_resolution_clock::now();
+			auto us = std::chrono::duration<double, std::micro>(stop - start).count() / targetCount;
+			std::cout << solver << ";" << targetCount << ";" << double(iterations) / targetCount << ";" << us << ";" << reached << std::endl;
+		};
+
+		report("ccd-10-rounds", [&](glm::vec2 target, int &reached) {
+			int rounds = CcdSolve(pose, target, tolerance);
+			pose.calc_Mi_a();
+			auto end = pose.getBone(BONE_COUNT - 1).transform_from_boneSpace(glm::vec3(BONE_LENGTH, 0, 0));
+			if (glm::length(glm::vec2(end) - target) <= tolerance) reached++;
+			return rounds;
+		});
+
+		for (auto [name, solver] : {std::pair<const char *, IKSolver *>{"fabrik", &fabrik}, {"dls", &dls}}) {
+			report(name, [&, solver = solver](glm::vec2 target, int &reached) {
+				auto result = solver->solve(chain, target, pose);
+				if (result.reached) reached++;
+				return result.iterations;
+			});
+		}
+	}
+
+	// hips, a three bone spine, and three bone arms and legs
+	Skeleton *CreateBiped() {
+		auto skeleton = new Skeleton();
+		int hips = skeleton->addBone(-1, "Hips", 10, glm::vec3(), glm::vec3(0, 0, glm::radians(90.0f)));
+		int spine = hips;
+		for (int i = 0; i < 3; i++)
+			spine = skeleton->addBone(spine, "Spine " + std::to_string(i + 1), 10, glm::vec3(), glm::vec3());
+		for (auto [side, angle] : {std::pair<const char *, float>{"L", 100.0f}, {"R", -100.0f}}) {
+			int arm = skeleton->addBone(spine, std::string("Arm ") + side, 12, glm::vec3(), glm::vec3(0, 0, glm::radians(angle)));
+			arm = skeleton->addBone(arm, std::string("Forearm ") + side, 12, glm::vec3(), glm::vec3());
+			skeleton->addBone(arm, std::string("Hand ") + side, 5, glm::vec3(), glm::vec3());
+		}
+		for (auto [side, angle] : {std::pair<const char *, float>{"L", 160.0f}, {"R", -160.0f}}) {
+			int leg = skeleton->addBone(hips, std::string("Leg ") + side, 15, glm::vec3(-10, 0, 0), glm::vec3(0, 0, glm::radians(angle)));
+			leg = skeleton->addBone(leg, std::string("Shin ") + side, 15, glm::vec3(), glm::vec3());
+			skeleton->addBone(leg, std::string("Foot ") + side, 5, glm::vec3(), glm::vec3());
+		}
+		skeleton->calc_Mi_d();
+		return skeleton;
+	}
+
+	void IKBatchBench() {
+		std::mt19937 random(1399);
+		auto skeleton = CreateBiped();
+
+		// hands and feet, each chain starts at the upper limb bone
+		std::vector<IKChain> chains;
+		for (auto [end, root] : {std::pair<const char *, const char *>{"Hand L", "Arm L"}, {"Hand R", "Arm R"}, {"Foot L", "Leg L"}, {"Foot R", "Leg R"}})
+			chains.push_back(IKChain::fromSkeleton(*skeleton, skeleton->findBone(end), skeleton->findBone(root)));
+
+		const int characterCount = 1000;
+		std::vector<Pose> poses(characterCount, Pose(skeleton));
+		for (auto &pose : poses) pose.calc_Mi_a();
+
+		// targets around the rest pose limb ends, so most of them are reachable
+		std::uniform_real_distribution<float> offset(-8, 8);
+		std::vector<glm::vec2> targets;
+		for (int i = 0; i < characterCount; i++)
+			for (auto &chain : chains) {
+				auto end = poses[i].getBone(chain.bones.back()).transform_from_boneSpace(glm::vec3(5, 0, 0));
+				targets.emplace_back(end.x + offset(random), end.y + offset(random));
+			}
+
+		DlsSolver prototype;
+		for (int threads : {1, 2, 4, 8, 16}) {
+			ThreadPool pool(threads - 1);
+			IKBatch batch(&pool, prototype);
+
+			Measure("ik-batch", characterCount * (int) chains.size(), threads, 50, [&](int) {
+				batch.clear();
+				for (int i = 0; i < characterCount; i++) {
+					poses[i].reset();
+					poses[i].calc_Mi_a();
+					for (int c = 0; c < (int) chains.size(); c++)
+						batch.add(&poses[i], &chains[c], targets[i * chains.size() + c]);
+				}
+				batch.solve();
+			});
+		}
+	}
+
+	void CrowdBench(ThreadPool &pool) {
+		std::mt19937 random(1399);
+		auto skeleton = CreateSkeleton();
+		auto clip = CreateClip(CreateKeyframes(KEYFRAME_COUNT, random));
+
+		auto mesh = CreateMesh(CreateSkin(CROWD_SKIN_SIZE, random));
+
+		for (int instanceCount : {100, 1000, 5000}) {
+			int frames = std::max(10, 100000 / instanceCount);
+			std::uniform_real_distribution<float> time(0, 12);
+
+			Crowd serial(skeleton, mesh.getView(), nullptr);
+			Crowd parallel(skeleton, mesh.getView(), &pool);
+			for (auto crowd : {&serial, &parallel}) {
+				crowd->SetClip(&clip);
+				for (int i = 0; i < instanceCount; i++) crowd->AddInstance(time(random));
+			}
+
+			Measure("crowd-animate", instanceCount, 1, frames, [&](int) {
+				serial.AnimateAll(1.0f / 60);
+			});
+
+			Measure("crowd-animate", instanceCount, pool.getThreadCount(), frames, [&](int) {
+				parallel.AnimateAll(1.0f / 60);
+			});
+		}
+	}
+
+	// what Game::initScene does, bones added by parent name and a skin generated along them
+	void BuildCharacter(Skeleton &skeleton, SkinnedMesh &mesh, AnimationClip &clip) {
+		const char *names[] = {"Bone 1", "Bone 2", "Bone 3", "Bone 4", "Bone 5", "Bone 5L", "Bone 6", "Bone 7", "Bone H"};
+		const char *parents[] = {"", "Bone 1", "Bone 2", "Bone 3", "Bone 4", "Bone 4", "Bone 5", "Bone 6", "Bone 7"};
+		const int lengths[] = {25, 10, 20, 10, 20, 10, 10, 10, 15};
+		for (int i = 0; i < 9; i++) {
+			float angle = i == 5 ? glm::radians(45.0f) : 0;
+			skeleton.addBone(skeleton.findBone(parents[i]), names[i], lengths[i], glm::vec3(), glm::vec3(0, 0, angle));
+		}
+		skeleton.calc_Mi_d();
+
+		float x = 0;
+		for (int i = 0; i < skeleton.getBoneCount(); i++) {
+			int segments = skeleton.getLength(i) * 10;
+			float step = float(skeleton.getLength(i)) / float(segments);
+			for (int j = 0; j < segments; j++) {
+				x += step;
+				float part = float(j) / float(segments);
+				for (auto y : {5.f, -5.f})
+					mesh.addVertex(glm::vec2(x, y), {{std::max(0, i - 1), 1 - part}, {i, part}});
+			}
+		}
+
+		for (int frame = 0; frame < KEYFRAME_COUNT; frame++)
+			for (int i = 0; i < skeleton.getBoneCount(); i++)
+				clip.setRotationKey(i, float(frame), glm::angleAxis(0.05f * float(frame - i), glm::vec3(0, 0, 1)));
+	}
+
+	long PageFaults() {
+		rusage usage{};
+		getrusage(RUSAGE_SELF, &usage);
+		return usage.ru_minflt + usage.ru_majflt;
+	}
+
+	// startup cost of many characters, built in code against mapped from rig asset files
+	void AssetBench() {
+		const int assetCount = 1000;
+		auto directory = std::filesystem::temp_directory_path() / "hw05-kinematic-bench";
+		std::filesystem::create_directories(directory);
+
+		std::cout << "startup;assets;ms;us_per_asset;page_faults_per_asset" << std::endl;
+		auto report = [&](const char *stage, auto start, long faults) {
+			auto ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+			std::cout << stage << ";" << assetCount << ";" << ms << ";" << ms * 1000 / assetCount << ";"
+			          << double(PageFaults() - faults) / assetCount << std::endl;
+		};
+
+		{
+			std::vector<Skeleton> skeletons(assetCount);
+			std::vector<SkinnedMesh> meshes(assetCount);
+			std::vector<AnimationClip> clips(assetCount, AnimationClip(KEYFRAME_COUNT));
+			auto faults = PageFaults();
+			auto start = std::chrono::high_resolution_clock::now();
+			for (int i = 0; i < assetCount; i++) BuildCharacter(skeletons[i], meshes[i], clips[i]);
+			report("build-in-code", start, faults);
+
+			for (int i = 0; i < assetCount; i++) {
+				auto path = directory / (std::to_string(i) + ".rig");
+				RigAsset::save(path.string(), skeletons[i], meshes[i].getView(), {&clips[i]});
+			}
+		}
+
+		std::vector<RigAsset> assets(assetCount);
+		std::vector<Skeleton> skeletons(assetCount);
+		std::vector<SkinnedMeshView> meshes(assetCount);
+		std::vector<AnimationClip> clips;
+		clips.reserve(assetCount);
+		auto faults = PageFaults();
+		auto start = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < assetCount; i++) {
+			auto path = directory / (std::to_string(i) + ".rig");
+			if (!assets[i].load(path.string())) {
+				std::cout << "could not load " << path << std::endl;
+				return;
+			}
+			assets[i].buildSkeleton(skeletons[i]);
+			meshes[i] = assets[i].getMesh();
+			clips.push_back(assets[i].getClip(0));
+		}
+		report("load-asset", start, faults);
+
+		for (auto &asset : assets) asset.unload();
+		std::filesystem::remove_all(directory);
+	}
+}
+
+namespace KinematicBench {
+	/// full tree, every bone above the last level has `branching` children
+	void AddSyntheticRig(Scene &scene, int depth, int branching) {
+		std::vector<std::string> level = {"Bone 0"};
+		scene.AddBone("", level[0], BONE_LENGTH, 0);
+		for (int d = 1; d < depth; d++) {
+			std::vector<std::string> next;
+			for (auto &parent : level) {
+				for (int c = 0; c < branching; c++) {
+					next.push_back("Bone " + std::to_string(scene.GetBoneCount()));
+					scene.AddBone(parent, next.back(), BONE_LENGTH, 0.4f * (float(c) - float(branching - 1) / 2));
+				}
+			}
+			level = next;
+		}
+	}
+
+	/// vertices spread evenly along the bind pose bones, blended with the parent towards the bone start
+	SkinnedMesh CreateSceneMesh(Scene &scene, int vertexCount) {
+		SkinnedMesh mesh;
+		const int boneCount = scene.GetBoneCount();
+		for (int i = 0; i < vertexCount; i++) {
+			int bone = i * boneCount / vertexCount;
+			int first = bone * vertexCount / boneCount;
+			int count = (bone + 1) * vertexCount / boneCount - first;
+			float u = float(i - first) / float(count);
+
+			auto b = scene.GetBone(bone);
+			auto parent = b.getParent();
+			auto position = b.transform_from_orig_boneSpace(glm::vec3(u * float(b.getLength()), i % 2 ? 3 : -3, 0));
+			mesh.addVertex(glm::vec2(position), {
+					{parent.isValid() ? parent.getIndex() : bone, 0.5f * (1 - u)},
+					{bone, 0.5f + 0.5f * u},
+			});
+		}
+		return mesh;
+	}
+
+	struct StageTime {
+		const char *name;
+		double ms = 0;
+		long allocations = 0;
+		int calls = 0;
+
+		template<class Fn>
+		void Run(Fn fn) {
+			auto allocations = allocationCount.load();
+			auto start = std::chrono::high_resolution_clock::now();
+			fn();
+			this->ms += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+			this->allocations += allocationCount.load() - allocations;
+			this->calls++;
+		}
+	};
+
+	// Scene::Animate, Scene::InverseKinematic and the pose and skin update of Scene::Update, timed apart
+	void SceneBench(int depth, int branching, int vertexCount, int frames) {
+		Scene scene;
+		AddSyntheticRig(scene, depth, branching);
+		std::cout << "rig;depth;branching;bones;vertices;frames" << std::endl;
+		std::cout << "synthetic;" << depth << ";" << branching << ";" << scene.GetBoneCount() << ";" << vertexCount << ";" << frames << std::endl;
+		if (scene.GetBoneCount() > 256) {
+			std::cout << "skinned meshes take at most 256 bones" << std::endl;
+			return;
+		}
+
+		scene.Init();
+		scene.SetSkin(CreateSceneMesh(scene, vertexCount));
+
+		// record a clip the way the editor does, one pose per function key
+		std::mt19937 random(1399);
+		std::uniform_real_distribution<float> angle(-0.3f, 0.3f);
+		for (int frame = 0; frame < KEYFRAME_COUNT; frame++) {
+			for (int i = 0; i < scene.GetBoneCount(); i++)
+				scene.GetBone(i).setQuat(glm::angleAxis(angle(random), glm::vec3(0, 0, 1)));
+			scene.SetKeyFrame(frame);
+		}
+
+		StageTime animate{"scene-animate"}, inverse{"scene-inverse"}, update{"scene-pose-skin"}, frame{"scene-frame"};
+		for (int i = 0; i < frames; i++) {
+			frame.Run([&]() {
+				scene.mode = Scene::MODE_NORMAL;
+				animate.Run([&]() { scene.Animate(1.0f / 60); });
+				update.Run([&]() { scene.Update(1.0f / 60); });
+
+				float t = float(i) / 60;
+				scene.inverse_target = glm::vec2(std::cos(t), std::sin(t)) * float(depth * BONE_LENGTH) * 0.7f;
+				inverse.Run([&]() { scene.InverseKinematic(); });
+				update.Run([&]() { scene.Update(1.0f / 60); });
+			});
+		}
+
+		std::cout << "stage;calls;ms_per_call;allocations_per_call" << std::endl;
+		for (auto stage : {&animate, &inverse, &update, &frame})
+			std::cout << stage->name << ";" << stage->calls << ";" << stage->ms / stage->calls << ";"
+			          << double(stage->allocations) / stage->calls << std::endl;
+	}
+}
+
+using namespace KinematicBench;
+
+int main(int argc, char **argv) {
+	if (argc == 5) {
+		const int depth = std::atoi(argv[1]), branching = std::atoi(argv[2]);
+		const int vertexCount = std::atoi(argv[3]), frames = std::atoi(argv[4]);
+		if (depth <= 0 || branching <= 0 || vertexCount <= 0 || frames <= 0) {
+			std::cerr << "depth, branching, vertices and frames must be positive" << std::endl;
+			return 1;
+		}
+		SceneBench(depth, branching, vertexCount, frames);
+		return 0;
+	}
+
+	ThreadPool pool;
+
+	std::cout << "stage;count;threads;ms_per_frame;count_per_ms" << std::endl;
+	SkinningBench(pool);
+	DirtyBench();
+	BoneUpdateBench();
+	ClipBench();
+	AnimatorBench();
+	CrowdBench(pool);
+
+	ClipMemory();
+	MeshMemory();
+	IKBench();
+
+	std::cout << "stage;count;threads;ms_per_frame;count_per_ms" << std::endl;
+	IKBatchBench();
+
+	AssetBench();
+
+	SceneBench(4, 3, 100000, 200);
+
+	return 0;
+}
@@ -7,23 +7,27 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
-class Bone {
-	friend class Skeleton;
+class Pose;
 
+/// handle to one bone of a Pose, all bone data lives in the pose and skeleton arrays
+class Bone {
 public:
 
-	Bone(int length, std::string name) :
-			length(length),
-			name(std::move(name)),
-			parent(nullptr),
-			Mi_p(1), Mi_d(1),
-			Mi_l(1), Mi_a(1),
-			t(0), quat(0, 0, 0, 0) {}
+	Bone() : pose(nullptr), index(-1) {}
 
-	void rotate(glm::vec3 theta);
+	Bone(Pose *pose, int index) : pose(pose), index(index) {}
 
-	void calc_Mi_d();
+	[[nodiscard]] inline bool isValid() const { return this->pose != nullptr && this->index >= 0; }
 
+	[[nodiscard]] inline int getIndex() const { return this->index; }
+
+	inline bool operator==(const Bone &other) const {
+		return this->pose == other.pose && this->index == other.index;
+	}
+
+	void rotate(glm::vec3 theta);
+
+	/// recomputes the animated pose of this bone and its subtree
 	void calc_Mi_a();
 
 	void calc_bone_point(glm::vec3 &p1, glm::vec3 &p2) const;
@@ -33,9 +37,9 @@ public:
 
 	void setQuat(const glm::quat &qua);
 
-	[[nodiscard]] glm::quat getQuat() const { return this->quat; }
+	[[nodiscard]] glm::quat getQuat() const;
 
-	[[nodiscard]] glm::vec3 getAxle() const { return glm::axis(this->quat); }
+	[[nodiscard]] glm::vec3 getAxle() const { return glm::axis(getQuat()); }
 
 	[[nodiscard]] glm::vec3 transform(const glm::vec3 &vertex) const;
 
@@ -43,28 +47,19 @@ public:
 
 	[[nodiscard]] glm::vec3 transform_from_orig_boneSpace(const glm::vec3 &vertex) const;
 
-	[[nodiscard]] inline int getLength() const { return this->length; }
-
-	[[nodiscard]] inline std::string getName() const { return this->name; }
+	[[nodiscard]] int getLength() const;
 
-	[[nodiscard]] inline glm::mat4 getLocalTransformation() const { return this->Mi_l; }
+	[[nodiscard]] std::string getName() const;
 
-	[[nodiscard]] inline Bone *getParent() const { return this->parent; }
+	[[nodiscard]] glm::mat4 getLocalTransformation() const;
 
-private:
+	/// bind pose charSpace to animated charSpace, what skinning applies to a vertex
+	[[nodiscard]] glm::mat4 getSkinningMatrix() const;
 
-	Bone *parent;
-	std::vector<Bone *> children;
+	[[nodiscard]] Bone getParent() const;
 
-	std::string name;
-	int length;
-
-	glm::mat4 Mi_p; // boneSpace to parentSpace
-	glm::mat4 Mi_d; // boneSpace to charSpace   					=>   Mi,dInv: charSpace(defPos) to boneSpace(defPos)
-	glm::mat4 Mi_l; // boneSpace transform (in animation)
-	glm::mat4 Mi_a; // charSpace transform (animation)
+private:
 
-	// Key Data
-	glm::vec3 t;
-	glm::quat quat;
-};
\ No newline at end of file
+	Pose *pose;
+	int index;
+};
@@ -0,0 +1,44 @@
+#include "Crowd.h"
+
+int Crowd::AddInstance(float time) {
+	const auto boneCount = this->skeleton->getBoneCount();
+	const auto vertexCount = this->mesh.vertexCount;
+
+	this->times.push_back(time);
+	this->cursors.emplace_back();
+	this->poses.emplace_back(this->skeleton);
+	this->matrices.resize(this->matrices.size() + boneCount);
+	this->x.resize(this->x.size() + vertexCount);
+	this->y.resize(this->y.size() + vertexCount);
+
+	return GetInstanceCount() - 1;
+}
+
+void Crowd::AnimateAll(float deltaTime) {
+	for (auto &time : this->times) time += deltaTime;
+
+	if (this->pool == nullptr) {
+		for (int i = 0; i < GetInstanceCount(); i++) AnimateInstance(i);
+		return;
+	}
+
+	this->pool->parallelFor(GetInstanceCount(), THREAD_GRAIN, [this](int begin, int end) {
+		for (int i = begin; i < end; i++) AnimateInstance(i);
+	});
+}
+
+void Crowd::AnimateInstance(int instance) {
+	const auto boneCount = this->skeleton->getBoneCount();
+	const auto vertexCount = this->mesh.vertexCount;
+	auto &pose = this->poses[instance];
+
+	if (this->clip != nullptr)
+		this->clip->sample(this->times[instance], this->cursors[instance], pose);
+
+	pose.calc_Mi_a();
+
+	auto m = this->matrices.data() + (size_t) instance * boneCount;
+	auto offset = (size_t) instance * vertexCount;
+	Skinning::calcMatrices(pose, m);
+	this->mesh.skinRange(m, this->x.data() + offset, this->y.data() + offset, 0, vertexCount);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include "AnimationClip.h"
+#include "Pose.h"
+#include "Skinning.h"
+#include "ThreadPool.h"
+
+/// many animated instances of one shared skeleton and skin.
+/// the skeleton, mesh and clip are read only, every instance only owns
+/// its animation time, clip cursor, pose, skinning matrices and skinned vertices.
+class Crowd {
+public:
+	static const int THREAD_GRAIN = 4;
+
+	/// pool may be null to run on the calling thread
+	Crowd(const Skeleton *skeleton, const SkinnedMeshView &mesh, ThreadPool *pool)
+			: skeleton(skeleton), mesh(mesh), pool(pool) {}
+
+	/// clip played by every instance, may be null to keep the bind pose
+	inline void SetClip(const AnimationClip *newClip) { this->clip = newClip; }
+
+	/// returns the instance index
+	int AddInstance(float time);
+
+	/// samples the clip, computes the global pose and skins every instance
+	void AnimateAll(float deltaTime);
+
+	[[nodiscard]] inline int GetInstanceCount() const { return (int) this->poses.size(); }
+
+	[[nodiscard]] inline const Pose &GetPose(int instance) const { return this->poses[instance]; }
+
+	[[nodiscard]] inline const float *GetX(int instance) const {
+		return this->x.data() + (size_t) instance * this->mesh.vertexCount;
+	}
+
+	[[nodiscard]] inline const float *GetY(int instance) const {
+		return this->y.data() + (size_t) instance * this->mesh.vertexCount;
+	}
+
+private:
+
+	void AnimateInstance(int instance);
+
+	const Skeleton *skeleton;
+	SkinnedMeshView mesh;
+	ThreadPool *pool;
+
+	const AnimationClip *clip = nullptr;
+
+	std::vector<float> times;
+	std::vector<ClipCursor> cursors;
+	std::vector<Pose> poses;
+	std::vector<SkinMatrix> matrices; // instance * boneCount + bone
+	std::vector<float> x; // instance * vertexCount + vertex
+	std::vector<float> y;
+};
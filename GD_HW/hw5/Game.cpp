@@ -15,6 +15,9 @@
 using namespace glm;
 
 namespace Game {
+	/// rig, skin and recorded clip, written with S and loaded on the next start
+	const char *RIG_ASSET = "character.rig";
+
 	Scene *scene;
 	GLFWwindow *window;
 
@@ -36,6 +39,10 @@ namespace Game {
 			scene->SelectBone(key - GLFW_KEY_1);
 		} else if (key == GLFW_KEY_F && action == GLFW_PRESS) {
 			scene->SwitchMode();
+		} else if (key == GLFW_KEY_I && action == GLFW_PRESS) {
+			scene->SwitchSolver();
+		} else if (key == GLFW_KEY_S && action == GLFW_PRESS) {
+			std::cout << (scene->SaveAsset(RIG_ASSET) ? "saved " : "could not save ") << RIG_ASSET << std::endl;
 		} else if (key == GLFW_KEY_SPACE && action == GLFW_PRESS) {
 			scene->PlayPause();
 		} else if (key >= GLFW_KEY_F1 && key <= GLFW_KEY_F19 && action == GLFW_PRESS) {
@@ -51,8 +58,8 @@ namespace Game {
 			is_mouse_press = true;
 
 			auto selectedBone = scene->GetSelectedBone();
-			if (selectedBone != nullptr) {
-				glm::quat quat = glm::quat_cast(selectedBone->getLocalTransformation());
+			if (selectedBone.isValid()) {
+				glm::quat quat = selectedBone.getQuat();
 				angle_of_selected_bone = glm::angle(quat);
 				axis_of_selected_bone = glm::axis(quat);
 			}
@@ -75,6 +82,7 @@ namespace Game {
 
 	void initScene() {
 		scene = new Scene();
+		if (scene->LoadAsset(RIG_ASSET)) return;
 
 		scene->AddBone("", "Bone 1", 25, 0);
 		scene->AddBone("Bone 1", "Bone 2", 10, 0);
@@ -93,7 +101,7 @@ namespace Game {
 
 		const int DefSegments = 100;
 
-		std::vector<Vertex> skin;
+		SkinnedMesh skin;
 		int bone_count = scene->GetBoneCount();
 		float x = 0;
 		for (int i = 0; i < bone_count; i++) {
@@ -101,29 +109,26 @@ namespace Game {
 			int next_bone_index = min(bone_count - 1, i + 1);
 
 			//Bone *previous_bone = scene->GetBone(previous_bone_index);
-			Bone *bone = scene->GetBone(i);
+			Bone bone = scene->GetBone(i);
 			//Bone *next_bone = scene->GetBone(next_bone_index);
 
 			// I add Variable segment count
 			// it depends on bone length
-			int Segments = (int) round((float) bone->getLength() / 10 * DefSegments);
-			float step = (float) bone->getLength() / Segments;
+			int Segments = (int) round((float) bone.getLength() / 10 * DefSegments);
+			float step = (float) bone.getLength() / Segments;
 			for (int j = 0; j < Segments; j++) {
 				x += step;
 				for (auto y : {5.f, -5.f}) {
 					float part = (float) j / Segments;
 					if (j < Segments / 2)
-						skin.push_back(Vertex{
-								x, y, previous_bone_index, i,
-								0.5f - part, 0.5f + part,
-								0, 0
+						skin.addVertex(glm::vec2(x, y), {
+								{previous_bone_index, 0.5f - part},
+								{i, 0.5f + part},
 						});
 					else
-						skin.push_back(Vertex{
-								x, y, i, next_bone_index,
-								(float) (1.0f - ((float) j - Segments / 2.0f) / Segments),
-								(float) (((float) j - Segments / 2.0f) / Segments),
-								0, 0
+						skin.addVertex(glm::vec2(x, y), {
+								{i, (float) (1.0f - ((float) j - Segments / 2.0f) / Segments)},
+								{next_bone_index, (float) (((float) j - Segments / 2.0f) / Segments)},
 						});
 				}
 			}
@@ -0,0 +1,59 @@
+#include <algorithm>
+#include "IKBatch.h"
+
+IKBatch::IKBatch(ThreadPool *pool, const IKSolver &prototype) : pool(pool) {
+	this->solvers.emplace_back(prototype.clone());
+}
+
+void IKBatch::clear() {
+	this->jobs.clear();
+}
+
+int IKBatch::add(Pose *pose, const IKChain *chain, glm::vec2 target) {
+	this->jobs.push_back(Job{pose, chain, target, IKResult{0, 0, false}});
+	return getJobCount() - 1;
+}
+
+void IKBatch::solve() {
+	const auto jobCount = getJobCount();
+
+	this->order.resize(jobCount);
+	for (int i = 0; i < jobCount; i++) this->order[i] = i;
+	std::sort(this->order.begin(), this->order.end(), [this](int a, int b) {
+		auto &ja = this->jobs[a];
+		auto &jb = this->jobs[b];
+		auto ra = &ja.pose->getSkeleton();
+		auto rb = &jb.pose->getSkeleton();
+		if (ra != rb) return ra < rb;
+		if (ja.pose != jb.pose) return ja.pose < jb.pose;
+		return a < b;
+	});
+
+	this->groups.clear();
+	for (int i = 0; i < jobCount; i++)
+		if (i == 0 || this->jobs[this->order[i]].pose != this->jobs[this->order[i - 1]].pose)
+			this->groups.push_back(i);
+	const auto groupCount = (int) this->groups.size();
+	this->groups.push_back(jobCount);
+
+	if (this->pool == nullptr) {
+		solveGroups(*this->solvers[0], 0, groupCount);
+		return;
+	}
+
+	// chunks are handed out once each, so the chunk index picks a solver no other thread is using
+	const int chunkCount = (groupCount + THREAD_GRAIN - 1) / THREAD_GRAIN;
+	while ((int) this->solvers.size() < chunkCount)
+		this->solvers.emplace_back(this->solvers[0]->clone());
+
+	this->pool->parallelFor(groupCount, THREAD_GRAIN, [this](int begin, int end) {
+		solveGroups(*this->solvers[begin / THREAD_GRAIN], begin, end);
+	});
+}
+
+void IKBatch::solveGroups(IKSolver &solver, int begin, int end) {
+	for (int i = this->groups[begin]; i < this->groups[end]; i++) {
+		auto &job = this->jobs[this->order[i]];
+		job.result = solver.solve(*job.chain, job.target, *job.pose);
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "IKSolver.h"
+#include "ThreadPool.h"
+
+/// many IK solves per frame, like the feet and hands of a whole crowd.
+/// jobs on the same pose run in the order they were added on one thread, since they share the pose globals.
+/// poses are sorted by rig, then the pose groups are spread over the pool with one solver per chunk.
+class IKBatch {
+public:
+	static const int THREAD_GRAIN = 16;
+
+	/// pool may be null to solve on the calling thread, prototype gives the solver kind and settings
+	IKBatch(ThreadPool *pool, const IKSolver &prototype);
+
+	void clear();
+
+	/// the global pose of the chain root parent has to be up to date when solve runs, returns the job index
+	int add(Pose *pose, const IKChain *chain, glm::vec2 target);
+
+	/// solves every job and writes the result into its pose
+	void solve();
+
+	[[nodiscard]] inline int getJobCount() const { return (int) this->jobs.size(); }
+
+	[[nodiscard]] inline const IKResult &getResult(int job) const { return this->jobs[job].result; }
+
+private:
+
+	struct Job {
+		Pose *pose;
+		const IKChain *chain;
+		glm::vec2 target;
+		IKResult result;
+	};
+
+	void solveGroups(IKSolver &solver, int begin, int end);
+
+	ThreadPool *pool;
+	std::vector<std::unique_ptr<IKSolver> > solvers;
+
+	std::vector<Job> jobs;
+	std::vector<int> order; // jobs sorted by rig and pose
+	std::vector<int> groups; // start of every pose in order, and the end
+};
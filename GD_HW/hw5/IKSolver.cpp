@@ -0,0 +1,213 @@
+#include <algorithm>
+#include <cmath>
+#include "IKSolver.h"
+
+static float wrapAngle(float angle) {
+	const float pi = glm::pi<float>();
+	angle = std::fmod(angle + pi, 2 * pi);
+	return angle < 0 ? angle + pi : angle - pi;
+}
+
+static float angleOf(const glm::mat4 &m) {
+	return std::atan2(m[0][1], m[0][0]);
+}
+
+static glm::vec2 direction(glm::vec2 from, glm::vec2 to) {
+	auto d = to - from;
+	auto length = glm::length(d);
+	return length > 1e-6f ? d / length : glm::vec2(1, 0);
+}
+
+IKChain IKChain::fromSkeleton(const Skeleton &skeleton, int endBone, int rootBone) {
+	IKChain chain;
+	for (int bone = endBone; bone >= 0; bone = skeleton.getParent(bone)) {
+		chain.bones.push_back(bone);
+		if (bone == rootBone) break;
+	}
+	std::reverse(chain.bones.begin(), chain.bones.end());
+	return chain;
+}
+
+void IKChain::setLimit(int chainIndex, float min, float max) {
+	if (this->minAngle.empty()) {
+		this->minAngle.assign(size(), -glm::pi<float>());
+		this->maxAngle.assign(size(), glm::pi<float>());
+	}
+	this->minAngle[chainIndex] = min;
+	this->maxAngle[chainIndex] = max;
+}
+
+IKResult IKSolver::solve(const IKChain &chain, glm::vec2 target, Pose &pose) {
+	if (chain.bones.empty()) return IKResult{0, 0, false};
+
+	auto &skeleton = pose.getSkeleton();
+	this->count = chain.size();
+	this->lengths.resize(this->count);
+	this->offsets.resize(this->count);
+	this->angles.resize(this->count);
+	this->joints.resize(this->count + 1);
+
+	const auto root = chain.bones[0];
+	const auto rootParent = skeleton.getParent(root);
+	auto frame = rootParent < 0 ? skeleton.getParentTransform(root) : pose.getGlobal(rootParent) * skeleton.getParentTransform(root);
+	this->base = glm::vec2(frame[3]);
+	this->baseAngle = angleOf(frame);
+
+	for (int j = 0; j < this->count; j++) {
+		auto bone = chain.bones[j];
+		this->lengths[j] = (float) skeleton.getLength(bone);
+		this->offsets[j] = j == 0 ? 0 : angleOf(skeleton.getParentTransform(bone));
+		this->angles[j] = pose.getBone(bone).getAngle();
+	}
+
+	this->limited = !chain.minAngle.empty();
+	this->minAngle.assign(this->count, -glm::pi<float>());
+	this->maxAngle.assign(this->count, glm::pi<float>());
+	if (this->limited) {
+		std::copy(chain.minAngle.begin(), chain.minAngle.end(), this->minAngle.begin());
+		std::copy(chain.maxAngle.begin(), chain.maxAngle.end(), this->maxAngle.begin());
+	}
+	clampAngles();
+	forward();
+
+	auto result = IKResult{0, endError(target), false};
+	if (result.error > this->tolerance) result = iterate(target);
+	else result.reached = true;
+
+	for (int j = 0; j < this->count; j++)
+		pose.setQuat(chain.bones[j], glm::angleAxis(this->angles[j], glm::vec3(0, 0, 1)));
+	pose.calc_Mi_a(root);
+
+	return result;
+}
+
+void IKSolver::forward() {
+	auto position = this->base;
+	auto angle = this->baseAngle;
+	for (int j = 0; j < this->count; j++) {
+		angle += this->offsets[j] + this->angles[j];
+		this->joints[j] = position;
+		position += this->lengths[j] * glm::vec2(std::cos(angle), std::sin(angle));
+	}
+	this->joints[this->count] = position;
+}
+
+void IKSolver::toAngles() {
+	auto parentAngle = this->baseAngle;
+	for (int j = 0; j < this->count; j++) {
+		auto d = this->joints[j + 1] - this->joints[j];
+		auto local = wrapAngle(std::atan2(d.y, d.x) - parentAngle - this->offsets[j]);
+		this->angles[j] = std::clamp(local, this->minAngle[j], this->maxAngle[j]);
+		parentAngle += this->offsets[j] + this->angles[j];
+		this->joints[j + 1] = this->joints[j] + this->lengths[j] * glm::vec2(std::cos(parentAngle), std::sin(parentAngle));
+	}
+}
+
+void IKSolver::clampAngles() {
+	for (int j = 0; j < this->count; j++)
+		this->angles[j] = std::clamp(wrapAngle(this->angles[j]), this->minAngle[j], this->maxAngle[j]);
+}
+
+IKResult FabrikSolver::iterate(glm::vec2 target) {
+	const int n = this->count;
+	float error = endError(target);
+
+	// past the stretched chain one pass points it at the target, more passes only repeat that
+	float reach = 0;
+	for (int j = 0; j < n; j++) reach += this->lengths[j];
+	const bool outOfReach = glm::length(target - this->base) > reach;
+
+	for (int iteration = 1; iteration <= this->maxIterations; iteration++) {
+		// backward, pin the end to the target
+		this->joints[n] = target;
+		for (int j = n - 1; j >= 0; j--)
+			this->joints[j] = this->joints[j + 1] + direction(this->joints[j + 1], this->joints[j]) * this->lengths[j];
+
+		// forward, pin the start back to the base and bend each joint only as far as its limit allows
+		this->joints[0] = this->base;
+		toAngles();
+
+		error = endError(target);
+		if (error <= this->tolerance) return IKResult{iteration, error, true};
+		if (outOfReach) return IKResult{iteration, error, false};
+	}
+	return IKResult{this->maxIterations, error, false};
+}
+
+IKResult DlsSolver::iterate(glm::vec2 target) {
+	const int n = this->count;
+	const float lambda2 = this->damping * this->damping;
+	float error = endError(target);
+
+	// joints held at a limit drop out of the jacobian until the solve pulls them back
+	this->locked.assign(n, 0);
+
+	// the jacobian is only good near the current pose, long steps are cut short
+	float maxStep = 0;
+	for (int j = 0; j < n; j++) maxStep += this->lengths[j];
+	maxStep *= this->maxStepRatio;
+
+	for (int iteration = 1; iteration <= this->maxIterations; iteration++) {
+		auto end = this->joints[n];
+		auto delta = target - end;
+		auto deltaLength = glm::length(delta);
+		if (deltaLength > maxStep) delta *= maxStep / deltaLength;
+
+		// J is 2 x n, column j is the end effector velocity of joint j: perp(end - joint j)
+		float a = lambda2, b = 0, d = lambda2;
+		for (int j = 0; j < n; j++) {
+			if (this->locked[j]) continue;
+			auto r = end - this->joints[j];
+			a += r.y * r.y;
+			b -= r.x * r.y;
+			d += r.x * r.x;
+		}
+
+		// dTheta = J^T (J J^T + lambda^2 I)^-1 delta
+		float det = a * d - b * b;
+		auto y = glm::vec2(d * delta.x - b * delta.y, a * delta.y - b * delta.x) / det;
+
+		this->previousAngles = this->angles;
+
+		bool lockChanged = false;
+		bool anyLocked = false;
+		for (int j = 0; j < n; j++) {
+			auto r = end - this->joints[j];
+			float step = -r.y * y.x + r.x * y.y;
+
+			if (this->locked[j]) {
+				bool inward = this->angles[j] >= this->maxAngle[j] ? step < 0 : step > 0;
+				if (!inward) continue;
+				this->locked[j] = 0;
+				lockChanged = true;
+			}
+
+			float angle = this->angles[j] + step;
+			if (!this->limited) {
+				this->angles[j] = wrapAngle(angle);
+				continue;
+			}
+			this->angles[j] = std::clamp(angle, this->minAngle[j], this->maxAngle[j]);
+			if (this->angles[j] != angle) {
+				this->locked[j] = 1;
+				lockChanged = true;
+			}
+			anyLocked |= this->locked[j] != 0;
+		}
+
+		forward();
+
+		float previousError = error;
+		error = endError(target);
+		if (error <= this->tolerance) return IKResult{iteration, error, true};
+
+		// pushed against the limits, keep the closest pose
+		if (anyLocked && error > previousError) {
+			this->angles = this->previousAngles;
+			forward();
+			return IKResult{iteration, previousError, false};
+		}
+		if (!lockChanged && std::fabs(previousError - error) < this->tolerance * 1e-3f) return IKResult{iteration, error, false};
+	}
+	return IKResult{this->maxIterations, error, false};
+}
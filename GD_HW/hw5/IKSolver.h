@@ -0,0 +1,95 @@
+#pragma once
+
+#include <vector>
+#include "Pose.h"
+
+/// bones an IK solve may rotate, root first, every bone is the parent of the next one.
+/// limits bound the local z angle of each bone, empty limits leave the chain free.
+struct IKChain {
+	std::vector<int> bones;
+	std::vector<float> minAngle;
+	std::vector<float> maxAngle;
+
+	/// walks the parents from endBone up to rootBone, or up to the skeleton root for -1
+	static IKChain fromSkeleton(const Skeleton &skeleton, int endBone, int rootBone = -1);
+
+	void setLimit(int chainIndex, float min, float max);
+
+	[[nodiscard]] inline int size() const { return (int) this->bones.size(); }
+};
+
+struct IKResult {
+	int iterations;
+	float error;
+	bool reached;
+};
+
+/// planar IK solver base, the rig only rotates about z.
+/// a solve copies the chain into flat angle and joint position arrays, iterates on those only,
+/// and writes the local rotations back into the pose once at the end.
+/// the scratch arrays are kept between solves, so one solver per thread solves without allocating.
+class IKSolver {
+public:
+	float tolerance = 0.01f;
+	int maxIterations = 64;
+
+	virtual ~IKSolver() = default;
+
+	/// new solver of the same kind and settings, for solving on another thread
+	[[nodiscard]] virtual IKSolver *clone() const = 0;
+
+	/// the global pose of the chain root parent has to be up to date, the chain globals are after the solve
+	IKResult solve(const IKChain &chain, glm::vec2 target, Pose &pose);
+
+protected:
+
+	/// moves the angles toward target, starts with the joints matching the angles
+	virtual IKResult iterate(glm::vec2 target) = 0;
+
+	/// joint positions from the angles
+	void forward();
+
+	/// angles from the joint positions, clamped to the limits, then the joints again from those angles
+	void toAngles();
+
+	void clampAngles();
+
+	[[nodiscard]] inline float endError(glm::vec2 target) const { return glm::length(this->joints.back() - target); }
+
+	int count = 0;
+	bool limited = false;
+	glm::vec2 base;
+	float baseAngle = 0;
+	std::vector<float> lengths;
+	std::vector<float> offsets; // bind rotation of each bone against its parent
+	std::vector<float> angles; // local z angle of each bone
+	std::vector<float> minAngle;
+	std::vector<float> maxAngle;
+	std::vector<glm::vec2> joints; // start of every bone and the chain end
+};
+
+/// forward and backward reaching, fast and stable for long chains
+class FabrikSolver : public IKSolver {
+public:
+	[[nodiscard]] IKSolver *clone() const override { return new FabrikSolver(*this); }
+
+protected:
+	IKResult iterate(glm::vec2 target) override;
+};
+
+/// damped least squares on the end effector jacobian, smooth near singular poses
+class DlsSolver : public IKSolver {
+public:
+	float damping = 5.0f;
+	/// longest end effector step of one iteration, against the chain length
+	float maxStepRatio = 0.25f;
+
+	[[nodiscard]] IKSolver *clone() const override { return new DlsSolver(*this); }
+
+protected:
+	IKResult iterate(glm::vec2 target) override;
+
+private:
+	std::vector<char> locked;
+	std::vector<float> previousAngles;
+};
@@ -0,0 +1,41 @@
+#include <algorithm>
+#include "Pose.h"
+#include <glm/gtx/quaternion.hpp>
+
+void Pose::reset() {
+	const auto boneCount = this->skeleton->getBoneCount();
+	this->Mi_a.assign(boneCount, glm::mat4(1));
+	this->quats.assign(boneCount, glm::quat(1, 0, 0, 0));
+	this->translations.assign(boneCount, glm::vec3(0));
+	this->dirty.assign(boneCount, 1);
+	this->updated.assign(boneCount, 0);
+	this->moved.assign(boneCount, 0);
+	this->anyMoved = false;
+}
+
+glm::mat4 Pose::getLocal(int bone) const {
+	auto Mi_l = glm::toMat4(this->quats[bone]);
+	Mi_l[3] = glm::vec4(this->translations[bone], 1);
+	return Mi_l;
+}
+
+void Pose::calc_Mi_a(int first) {
+	// parents come before their children, so one pass in bone order carries a rebuild down its subtree
+	for (int i = first; i < getBoneCount(); i++) {
+		auto parent = this->skeleton->getParent(i);
+		this->updated[i] = this->dirty[i] || (parent >= first && this->updated[parent]);
+		if (!this->updated[i]) continue;
+
+		auto Mi_l = getLocal(i);
+		this->Mi_a[i] = parent < 0 ? Mi_l : this->Mi_a[parent] * this->skeleton->getParentTransform(i) * Mi_l;
+		this->dirty[i] = 0;
+		this->moved[i] = 1;
+		this->anyMoved = true;
+	}
+}
+
+void Pose::clearMoved() {
+	if (!this->anyMoved) return;
+	std::fill(this->moved.begin(), this->moved.end(), 0);
+	this->anyMoved = false;
+}
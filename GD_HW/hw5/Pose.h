@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cmath>
+#include "Skeleton.h"
+
+/// normalized lerp on the shorter arc, close to slerp for nearby rotations and much cheaper
+inline glm::quat nlerp(const glm::quat &a, const glm::quat &b, float u) {
+	float sign = glm::dot(a, b) < 0 ? -1.0f : 1.0f;
+	return glm::normalize(glm::quat(
+			a.w + (sign * b.w - a.w) * u,
+			a.x + (sign * b.x - a.x) * u,
+			a.y + (sign * b.y - a.y) * u,
+			a.z + (sign * b.z - a.z) * u));
+}
+
+/// nlerp while the rotations are close, slerp once the nlerp speed error would show
+inline glm::quat blendQuat(const glm::quat &a, const glm::quat &b, float u) {
+	return std::fabs(glm::dot(a, b)) > 0.95f ? nlerp(a, b, u) : glm::slerp(a, b, u);
+}
+
+/// animated state of one instance of a shared Skeleton.
+/// bone locals are a rotation and a translation, the local and global matrices are only built by calc_Mi_a.
+/// everything is kept in flat arrays in the skeleton bone order.
+/// setters flag a bone dirty only when its value really changes, calc_Mi_a then rebuilds just the dirty subtrees
+/// and flags the bones whose global moved, until the consumer (skinning, rendering) calls clearMoved.
+class Pose {
+public:
+
+	explicit Pose(const Skeleton *skeleton) : skeleton(skeleton) { reset(); }
+
+	/// sizes the pose to the skeleton and puts every bone back to its bind pose
+	void reset();
+
+	[[nodiscard]] inline const Skeleton &getSkeleton() const { return *this->skeleton; }
+
+	[[nodiscard]] inline int getBoneCount() const { return (int) this->quats.size(); }
+
+	[[nodiscard]] inline Bone getBone(int bone_index) { return Bone(this, bone_index); }
+
+	/// boneSpace transform (in animation), built from the rotation and translation
+	[[nodiscard]] glm::mat4 getLocal(int bone) const;
+
+	[[nodiscard]] inline const glm::mat4 &getGlobal(int bone) const { return this->Mi_a[bone]; }
+
+	[[nodiscard]] inline const glm::quat &getQuat(int bone) const { return this->quats[bone]; }
+
+	[[nodiscard]] inline const glm::vec3 &getTranslation(int bone) const { return this->translations[bone]; }
+
+	[[nodiscard]] inline glm::mat4 getSkinningMatrix(int bone) const {
+		return this->Mi_a[bone] * this->skeleton->getInverseBindPose(bone);
+	}
+
+	inline void setQuat(int bone, const glm::quat &quat) {
+		if (this->quats[bone] == quat) return;
+		this->quats[bone] = quat;
+		this->dirty[bone] = 1;
+	}
+
+	inline void setTransform(int bone, const glm::quat &quat, const glm::vec3 &translation) {
+		if (this->quats[bone] == quat && this->translations[bone] == translation) return;
+		this->quats[bone] = quat;
+		this->translations[bone] = translation;
+		this->dirty[bone] = 1;
+	}
+
+	/// forces a rebuild of bone and its subtree on the next calc_Mi_a
+	inline void markDirty(int bone) { this->dirty[bone] = 1; }
+
+	/// animated pose of the dirty bones from `first` on and of everything below them,
+	/// a call from a subtree root covers its whole subtree
+	void calc_Mi_a(int first = 0);
+
+	/// true if the global of bone changed since the last clearMoved
+	[[nodiscard]] inline bool isMoved(int bone) const { return this->moved[bone] != 0; }
+
+	[[nodiscard]] inline bool hasMoved() const { return this->anyMoved; }
+
+	void clearMoved();
+
+private:
+
+	const Skeleton *skeleton;
+
+	std::vector<glm::mat4> Mi_a; // charSpace transform (animation)
+
+	// Key Data
+	std::vector<glm::quat> quats;
+	std::vector<glm::vec3> translations;
+
+	// change tracking
+	std::vector<char> dirty;   // local changed since the last calc_Mi_a
+	std::vector<char> updated; // rebuilt by the running calc_Mi_a pass
+	std::vector<char> moved;   // global changed since the last clearMoved
+	bool anyMoved = false;
+};
@@ -0,0 +1,72 @@
+#include <algorithm>
+#include <cmath>
+#include "PoseBuffer.h"
+
+void PoseBuffer::resize(int boneCount) {
+	for (auto array : {&this->qx, &this->qy, &this->qz, &this->qw, &this->tx, &this->ty, &this->tz})
+		array->resize(boneCount);
+	setIdentity();
+}
+
+void PoseBuffer::setIdentity() {
+	for (auto array : {&this->qx, &this->qy, &this->qz, &this->tx, &this->ty, &this->tz})
+		std::fill(array->begin(), array->end(), 0.0f);
+	std::fill(this->qw.begin(), this->qw.end(), 1.0f);
+}
+
+void PoseBuffer::apply(Pose &pose) const {
+	const auto boneCount = std::min(getBoneCount(), pose.getBoneCount());
+	for (int i = 0; i < boneCount; i++)
+		pose.setTransform(i, getRotation(i), getTranslation(i));
+}
+
+void PoseBuffer::blend(const PoseBuffer &a, const PoseBuffer &b, float weight, const float *mask, PoseBuffer &out) {
+	const auto boneCount = out.getBoneCount();
+	for (int i = 0; i < boneCount; i++) {
+		float w = mask == nullptr ? weight : weight * mask[i];
+
+		// shorter arc, then a normalized lerp
+		float dot = a.qx[i] * b.qx[i] + a.qy[i] * b.qy[i] + a.qz[i] * b.qz[i] + a.qw[i] * b.qw[i];
+		float wb = dot < 0 ? -w : w;
+		float wa = 1 - w;
+
+		float x = a.qx[i] * wa + b.qx[i] * wb;
+		float y = a.qy[i] * wa + b.qy[i] * wb;
+		float z = a.qz[i] * wa + b.qz[i] * wb;
+		float s = a.qw[i] * wa + b.qw[i] * wb;
+		float inv = 1 / std::sqrt(x * x + y * y + z * z + s * s);
+
+		out.qx[i] = x * inv;
+		out.qy[i] = y * inv;
+		out.qz[i] = z * inv;
+		out.qw[i] = s * inv;
+		out.tx[i] = a.tx[i] * wa + b.tx[i] * w;
+		out.ty[i] = a.ty[i] * wa + b.ty[i] * w;
+		out.tz[i] = a.tz[i] * wa + b.tz[i] * w;
+	}
+}
+
+void PoseBuffer::add(const PoseBuffer &base, const PoseBuffer &additive, float weight, const float *mask, PoseBuffer &out) {
+	const auto boneCount = out.getBoneCount();
+	for (int i = 0; i < boneCount; i++) {
+		float w = mask == nullptr ? weight : weight * mask[i];
+
+		// scale the offset rotation by nlerp from the identity, on the shorter arc
+		float ws = additive.qw[i] < 0 ? -w : w;
+		float ax = additive.qx[i] * ws;
+		float ay = additive.qy[i] * ws;
+		float az = additive.qz[i] * ws;
+		float as = additive.qw[i] * ws + (1 - w);
+		float inv = 1 / std::sqrt(ax * ax + ay * ay + az * az + as * as);
+		ax *= inv, ay *= inv, az *= inv, as *= inv;
+
+		float bx = base.qx[i], by = base.qy[i], bz = base.qz[i], bs = base.qw[i];
+		out.qx[i] = bs * ax + bx * as + by * az - bz * ay;
+		out.qy[i] = bs * ay - bx * az + by * as + bz * ax;
+		out.qz[i] = bs * az + bx * ay - by * ax + bz * as;
+		out.qw[i] = bs * as - bx * ax - by * ay - bz * az;
+		out.tx[i] = base.tx[i] + additive.tx[i] * w;
+		out.ty[i] = base.ty[i] + additive.ty[i] * w;
+		out.tz[i] = base.tz[i] + additive.tz[i] * w;
+	}
+}
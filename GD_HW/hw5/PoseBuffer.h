@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+#include "Pose.h"
+
+/// bone local transforms as SoA arrays, the working format of animation blending.
+/// buffers are sized once to the rig, blending into them never allocates.
+class PoseBuffer {
+public:
+
+	PoseBuffer() = default;
+
+	explicit PoseBuffer(int boneCount) { resize(boneCount); }
+
+	/// resizes and resets every bone to the identity
+	void resize(int boneCount);
+
+	void setIdentity();
+
+	[[nodiscard]] inline int getBoneCount() const { return (int) this->qw.size(); }
+
+	inline void set(int bone, const glm::quat &rotation, const glm::vec3 &translation) {
+		this->qx[bone] = rotation.x;
+		this->qy[bone] = rotation.y;
+		this->qz[bone] = rotation.z;
+		this->qw[bone] = rotation.w;
+		this->tx[bone] = translation.x;
+		this->ty[bone] = translation.y;
+		this->tz[bone] = translation.z;
+	}
+
+	[[nodiscard]] inline glm::quat getRotation(int bone) const {
+		return glm::quat(this->qw[bone], this->qx[bone], this->qy[bone], this->qz[bone]);
+	}
+
+	[[nodiscard]] inline glm::vec3 getTranslation(int bone) const {
+		return glm::vec3(this->tx[bone], this->ty[bone], this->tz[bone]);
+	}
+
+	/// copies the locals into the pose, the global pose still needs calc_Mi_a
+	void apply(Pose &pose) const;
+
+	/// out = nlerp(a, b, weight * mask[bone]) per bone, mask may be null for weight on every bone.
+	/// out may be a or b.
+	static void blend(const PoseBuffer &a, const PoseBuffer &b, float weight, const float *mask, PoseBuffer &out);
+
+	/// out = base * (additive scaled by weight * mask[bone]), additive holds offsets from the rest pose.
+	/// out may be base.
+	static void add(const PoseBuffer &base, const PoseBuffer &additive, float weight, const float *mask, PoseBuffer &out);
+
+private:
+
+	std::vector<float> qx, qy, qz, qw;
+	std::vector<float> tx, ty, tz;
+};
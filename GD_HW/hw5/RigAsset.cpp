@@ -0,0 +1,250 @@
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+#include "RigAsset.h"
+
+static const char ASSET_MAGIC[4] = {'H', 'K', 'R', 'A'};
+static const size_t SECTION_ALIGN = 16;
+
+/// appends count items at the next section boundary, returns their offset
+template<class T>
+static uint64_t append(std::vector<uint8_t> &buffer, const T *items, size_t count) {
+	buffer.resize((buffer.size() + SECTION_ALIGN - 1) / SECTION_ALIGN * SECTION_ALIGN);
+	auto offset = buffer.size();
+	buffer.resize(offset + count * sizeof(T));
+	if (count > 0) std::memcpy(buffer.data() + offset, items, count * sizeof(T));
+	return offset;
+}
+
+std::vector<uint8_t> RigAsset::write(const Skeleton &skeleton, const SkinnedMeshView &mesh,
+                                     const std::vector<const AnimationClip *> &clips) {
+	std::vector<uint8_t> buffer(sizeof(AssetHeader));
+	AssetHeader header{};
+	std::memcpy(header.magic, ASSET_MAGIC, sizeof(ASSET_MAGIC));
+	header.version = VERSION;
+
+	// rig
+	std::vector<AssetBone> bones(skeleton.getBoneCount());
+	std::string names;
+	for (int i = 0; i < skeleton.getBoneCount(); i++) {
+		auto &bone = bones[i];
+		bone.parent = skeleton.getParent(i);
+		bone.length = skeleton.getLength(i);
+		bone.name = (uint32_t) names.size();
+		bone.nameLength = (uint32_t) skeleton.getName(i).size();
+		std::memcpy(bone.parentTransform, &skeleton.getParentTransform(i)[0][0], sizeof(bone.parentTransform));
+		names += skeleton.getName(i);
+	}
+	header.boneCount = (uint32_t) bones.size();
+	header.nameBytes = (uint32_t) names.size();
+	header.bones = append(buffer, bones.data(), bones.size());
+	header.names = append(buffer, names.data(), names.size());
+
+	// skin
+	const size_t slots = (size_t) mesh.vertexCount * SkinnedMesh::MAX_INFLUENCES;
+	header.vertexCount = mesh.vertexCount;
+	header.batchCount = mesh.batchCount;
+	header.batchBoneCount = mesh.batchCount > 0 ? mesh.batchStart[mesh.batchCount] : 0;
+	header.bindX = append(buffer, mesh.bind_x, mesh.vertexCount);
+	header.bindY = append(buffer, mesh.bind_y, mesh.vertexCount);
+	header.vertexBones = append(buffer, mesh.bones, slots);
+	header.vertexWeights = append(buffer, mesh.weights, slots);
+	header.batchStart = append(buffer, mesh.batchStart, mesh.batchCount > 0 ? mesh.batchCount + 1 : 0);
+	header.batchBones = append(buffer, mesh.batchBones, header.batchBoneCount);
+	header.batchInfluences = append(buffer, mesh.batchInfluences, mesh.batchCount);
+
+	// clips, the tables are written after their keys so every offset is known when a table is appended
+	std::vector<AssetClip> assetClips;
+	for (auto clip : clips) {
+		std::vector<AssetTrack> tracks(clip->getBoneCount());
+		for (int i = 0; i < clip->getBoneCount(); i++) {
+			auto &rotation = clip->getRotationTrack(i);
+			auto &translation = clip->getTranslationTrack(i);
+			auto &track = tracks[i];
+			track.rotationCount = (uint32_t) rotation.times.size();
+			track.translationCount = (uint32_t) translation.times.size();
+			track.rotationTimes = append(buffer, rotation.times.data(), rotation.times.size());
+			track.rotations = append(buffer, rotation.keys.data(), rotation.keys.size());
+			track.translationTimes = append(buffer, translation.times.data(), translation.times.size());
+			track.translations = append(buffer, translation.keys.data(), translation.keys.size());
+		}
+		assetClips.push_back(AssetClip{clip->getDuration(), (uint32_t) tracks.size(), append(buffer, tracks.data(), tracks.size())});
+	}
+	header.clipCount = (uint32_t) assetClips.size();
+	header.clips = append(buffer, assetClips.data(), assetClips.size());
+
+	header.fileSize = buffer.size();
+	std::memcpy(buffer.data(), &header, sizeof(header));
+	return buffer;
+}
+
+bool RigAsset::save(const std::string &path, const Skeleton &skeleton, const SkinnedMeshView &mesh,
+                    const std::vector<const AnimationClip *> &clips) {
+	auto buffer = write(skeleton, mesh, clips);
+
+	auto temporary = path + ".tmp";
+	auto file = std::fopen(temporary.c_str(), "wb");
+	if (file == nullptr) return false;
+	bool written = std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+	written = std::fclose(file) == 0 && written;
+
+	if (!written || std::rename(temporary.c_str(), path.c_str()) != 0) {
+		std::remove(temporary.c_str());
+		return false;
+	}
+	return true;
+}
+
+bool RigAsset::load(const std::string &path) {
+	unload();
+
+	int file = open(path.c_str(), O_RDONLY);
+	if (file < 0) return false;
+
+	struct stat status{};
+	void *mapping = MAP_FAILED;
+	if (fstat(file, &status) == 0 && status.st_size >= (off_t) sizeof(AssetHeader))
+		mapping = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+	if (mapping == MAP_FAILED) return false;
+
+	this->data = (const uint8_t *) mapping;
+	this->size = status.st_size;
+	if (!validate()) {
+		unload();
+		return false;
+	}
+	return true;
+}
+
+RigAsset::RigAsset(RigAsset &&other) noexcept: data(other.data), size(other.size) {
+	other.data = nullptr;
+	other.size = 0;
+}
+
+RigAsset &RigAsset::operator=(RigAsset &&other) noexcept {
+	if (this != &other) {
+		unload();
+		std::swap(this->data, other.data);
+		std::swap(this->size, other.size);
+	}
+	return *this;
+}
+
+void RigAsset::unload() {
+	if (this->data != nullptr) munmap((void *) this->data, this->size);
+	this->data = nullptr;
+	this->size = 0;
+}
+
+/// true if the key times never go back and stay in [0, duration]
+static bool inClipOrder(const float *times, uint32_t count, float duration) {
+	for (uint32_t i = 0; i < count; i++) {
+		if (!(times[i] >= 0 && times[i] <= duration)) return false;
+		if (i > 0 && times[i] < times[i - 1]) return false;
+	}
+	return true;
+}
+
+template<class T>
+bool RigAsset::contains(uint64_t offset, uint64_t count) const {
+	return offset % alignof(T) == 0 && offset <= this->size && count <= (this->size - offset) / sizeof(T);
+}
+
+bool RigAsset::validate() const {
+	auto &header = getHeader();
+	if (std::memcmp(header.magic, ASSET_MAGIC, sizeof(ASSET_MAGIC)) != 0) return false;
+	if (header.version != VERSION || header.fileSize != this->size) return false;
+
+	const uint64_t slots = (uint64_t) header.vertexCount * SkinnedMesh::MAX_INFLUENCES;
+	const uint64_t batches = header.vertexCount == 0 ? 0 : (header.vertexCount - 1) / SkinnedMesh::BATCH_SIZE + 1;
+	if (header.batchCount != batches) return false;
+	if (!contains<AssetBone>(header.bones, header.boneCount) || !contains<char>(header.names, header.nameBytes) ||
+	    !contains<float>(header.bindX, header.vertexCount) || !contains<float>(header.bindY, header.vertexCount) ||
+	    !contains<uint8_t>(header.vertexBones, slots) || !contains<uint16_t>(header.vertexWeights, slots) ||
+	    !contains<int32_t>(header.batchStart, batches > 0 ? batches + 1 : 0) ||
+	    !contains<uint8_t>(header.batchBones, header.batchBoneCount) ||
+	    !contains<uint8_t>(header.batchInfluences, batches) ||
+	    !contains<AssetClip>(header.clips, header.clipCount))
+		return false;
+
+	// indices are trusted by the skinning loop, so they are checked once here
+	auto bones = at<AssetBone>(header.bones);
+	for (uint32_t i = 0; i < header.boneCount; i++) {
+		if (bones[i].parent < -1 || bones[i].parent >= (int32_t) i || (uint64_t) bones[i].name + bones[i].nameLength > header.nameBytes)
+			return false;
+	}
+	auto vertexBones = at<uint8_t>(header.vertexBones);
+	for (uint64_t i = 0; i < slots; i++)
+		if (vertexBones[i] >= header.boneCount) return false;
+	auto batchBones = at<uint8_t>(header.batchBones);
+	for (uint64_t i = 0; i < header.batchBoneCount; i++)
+		if (batchBones[i] >= header.boneCount) return false;
+	auto batchStart = at<int32_t>(header.batchStart);
+	for (uint64_t i = 0; i < batches; i++)
+		if (batchStart[i] < 0 || batchStart[i] > batchStart[i + 1]) return false;
+	if (batches > 0 && (batchStart[0] != 0 || (uint32_t) batchStart[batches] != header.batchBoneCount)) return false;
+	auto batchInfluences = at<uint8_t>(header.batchInfluences);
+	for (uint64_t i = 0; i < batches; i++)
+		if (batchInfluences[i] > SkinnedMesh::MAX_INFLUENCES) return false;
+
+	auto clips = at<AssetClip>(header.clips);
+	for (uint32_t c = 0; c < header.clipCount; c++) {
+		if (!(clips[c].duration > 0) || !contains<AssetTrack>(clips[c].tracks, clips[c].trackCount)) return false;
+		auto tracks = at<AssetTrack>(clips[c].tracks);
+		for (uint32_t i = 0; i < clips[c].trackCount; i++) {
+			auto &track = tracks[i];
+			if (!contains<float>(track.rotationTimes, track.rotationCount) ||
+			    !contains<PackedQuat>(track.rotations, track.rotationCount) ||
+			    !contains<float>(track.translationTimes, track.translationCount) ||
+			    !contains<glm::vec3>(track.translations, track.translationCount))
+				return false;
+			// the cursor search of Track::find needs keys in order and inside the clip
+			if (!inClipOrder(at<float>(track.rotationTimes), track.rotationCount, clips[c].duration) ||
+			    !inClipOrder(at<float>(track.translationTimes), track.translationCount, clips[c].duration))
+				return false;
+		}
+	}
+	return true;
+}
+
+void RigAsset::buildSkeleton(Skeleton &skeleton) const {
+	auto &header = getHeader();
+	auto bones = at<AssetBone>(header.bones);
+	auto names = at<char>(header.names);
+
+	skeleton = Skeleton();
+	for (uint32_t i = 0; i < header.boneCount; i++) {
+		glm::mat4 parentTransform;
+		std::memcpy(&parentTransform[0][0], bones[i].parentTransform, sizeof(bones[i].parentTransform));
+		skeleton.addBone(bones[i].parent, std::string(names + bones[i].name, bones[i].nameLength), bones[i].length, parentTransform);
+	}
+	skeleton.calc_Mi_d();
+}
+
+SkinnedMeshView RigAsset::getMesh() const {
+	auto &header = getHeader();
+	return SkinnedMeshView{
+			(int) header.vertexCount, (int) header.batchCount,
+			at<float>(header.bindX), at<float>(header.bindY),
+			at<uint8_t>(header.vertexBones), at<uint16_t>(header.vertexWeights),
+			at<int32_t>(header.batchStart), at<uint8_t>(header.batchBones), at<uint8_t>(header.batchInfluences),
+	};
+}
+
+AnimationClip RigAsset::getClip(int clip) const {
+	auto &assetClip = at<AssetClip>(getHeader().clips)[clip];
+	auto tracks = at<AssetTrack>(assetClip.tracks);
+
+	AnimationClip result(assetClip.duration);
+	for (uint32_t i = 0; i < assetClip.trackCount; i++) {
+		auto &track = tracks[i];
+		result.setRotationTrack((int) i, at<float>(track.rotationTimes), at<PackedQuat>(track.rotations), (int) track.rotationCount);
+		result.setTranslationTrack((int) i, at<float>(track.translationTimes), at<glm::vec3>(track.translations), (int) track.translationCount);
+	}
+	return result;
+}
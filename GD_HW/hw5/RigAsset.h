@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "AnimationClip.h"
+#include "Skeleton.h"
+#include "SkinnedMesh.h"
+
+/// on disk layout of a rig asset, every section is found by its byte offset from the file start.
+/// sections are 16 byte aligned so they can be read in place from the mapping, numbers are little endian.
+struct AssetHeader {
+	char magic[4]; // "HKRA"
+	uint32_t version;
+	uint64_t fileSize;
+
+	uint32_t boneCount;
+	uint32_t nameBytes;
+	uint32_t vertexCount;
+	uint32_t batchCount;
+	uint32_t batchBoneCount;
+	uint32_t clipCount;
+
+	uint64_t bones; // AssetBone[boneCount]
+	uint64_t names; // char[nameBytes], not terminated
+	uint64_t bindX; // float[vertexCount]
+	uint64_t bindY; // float[vertexCount]
+	uint64_t vertexBones; // uint8[vertexCount * MAX_INFLUENCES]
+	uint64_t vertexWeights; // uint16[vertexCount * MAX_INFLUENCES]
+	uint64_t batchStart; // int32[batchCount + 1]
+	uint64_t batchBones; // uint8[batchBoneCount]
+	uint64_t batchInfluences; // uint8[batchCount]
+	uint64_t clips; // AssetClip[clipCount]
+};
+
+struct AssetBone {
+	int32_t parent;
+	int32_t length;
+	uint32_t name; // offset in the name section
+	uint32_t nameLength;
+	float parentTransform[16]; // Mi_p, column major
+};
+
+struct AssetClip {
+	float duration;
+	uint32_t trackCount;
+	uint64_t tracks; // AssetTrack[trackCount]
+};
+
+struct AssetTrack {
+	uint32_t rotationCount;
+	uint32_t translationCount;
+	uint64_t rotationTimes; // float[rotationCount]
+	uint64_t rotations; // PackedQuat[rotationCount]
+	uint64_t translationTimes; // float[translationCount]
+	uint64_t translations; // vec3[translationCount]
+};
+
+/// versioned binary file with a skeleton, its skinned mesh and its clips, memory mapped read only.
+/// the mesh is skinned straight from the mapping, the skeleton and clips are small and rebuilt from it
+/// with one copy per array. the mapping lives as long as the asset, so views of it must not outlive it.
+class RigAsset {
+public:
+	static const uint32_t VERSION = 1;
+
+	RigAsset() = default;
+
+	RigAsset(const RigAsset &) = delete;
+
+	RigAsset &operator=(const RigAsset &) = delete;
+
+	/// the mapping moves with the asset, views of it stay valid
+	RigAsset(RigAsset &&other) noexcept;
+
+	RigAsset &operator=(RigAsset &&other) noexcept;
+
+	~RigAsset() { unload(); }
+
+	/// writes next to path and renames over it, so a mapped older version stays valid.
+	/// returns false if the file could not be written
+	static bool save(const std::string &path, const Skeleton &skeleton, const SkinnedMeshView &mesh,
+	                 const std::vector<const AnimationClip *> &clips);
+
+	/// same layout into a memory buffer
+	static std::vector<uint8_t> write(const Skeleton &skeleton, const SkinnedMeshView &mesh,
+	                                  const std::vector<const AnimationClip *> &clips);
+
+	/// maps path, returns false if it is missing, truncated, damaged or of another version
+	bool load(const std::string &path);
+
+	void unload();
+
+	[[nodiscard]] inline bool isLoaded() const { return this->data != nullptr; }
+
+	/// replaces skeleton with the asset rig and computes its bind pose
+	void buildSkeleton(Skeleton &skeleton) const;
+
+	/// points into the mapping
+	[[nodiscard]] SkinnedMeshView getMesh() const;
+
+	[[nodiscard]] inline int getClipCount() const { return (int) getHeader().clipCount; }
+
+	[[nodiscard]] AnimationClip getClip(int clip) const;
+
+private:
+
+	[[nodiscard]] inline const AssetHeader &getHeader() const { return *(const AssetHeader *) this->data; }
+
+	template<class T>
+	[[nodiscard]] inline const T *at(uint64_t offset) const { return (const T *) (this->data + offset); }
+
+	/// true if count items of T at offset are inside the file and aligned
+	template<class T>
+	[[nodiscard]] bool contains(uint64_t offset, uint64_t count) const;
+
+	[[nodiscard]] bool validate() const;
+
+	const uint8_t *data = nullptr;
+	size_t size = 0;
+};
@@ -1,21 +1,18 @@
 #pragma once
 
 #include <iostream>
+#include <memory>
 #include "Skeleton.h"
+#include "Pose.h"
+#include "AnimationClip.h"
+#include "AnimationStateMachine.h"
+#include "IKSolver.h"
+#include "RigAsset.h"
+#include "Skinning.h"
+#include "ThreadPool.h"
 
 #define KEYFRAME_COUNT 12
 
-struct Vertex {
-	float orig_x;
-	float orig_y;
-	int bone_1;
-	int bone_2;
-	float weigth_1;
-	float weigth_2;
-	float x;
-	float y;
-};
-
 static const char *MODE_NAMES[] = {"Normal", "Inverse", "Review", "Animation"};
 
 class Scene {
@@ -32,16 +29,18 @@ public:
 	MODE_ANIMATION = 3;
 
 	Scene()
-			: selectedBone(nullptr), keyframes(KEYFRAME_COUNT), inverse_target(0, 0) {
-		skeleton = new Skeleton();
+			: inverse_target(0, 0), selectedBone(-1), clip(KEYFRAME_COUNT) {
+		skeleton = std::make_unique<Skeleton>();
+		pose = std::make_unique<Pose>(skeleton.get());
+		pool = std::make_unique<ThreadPool>();
 		mode = MODE_NORMAL;
 	}
 
 	void AddBone(const std::string &parent, const std::string &bone_name, int length, float angle);
 
-	Bone *GetBone(const std::string &bone_name);
+	Bone GetBone(const std::string &bone_name);
 
-	Bone *GetBone(int bone_index);
+	Bone GetBone(int bone_index);
 
 	int GetBoneCount();
 
@@ -51,13 +50,22 @@ public:
 
 	void RotateSelectedBone(float delta_theta);
 
-	Bone *GetSelectedBone();
+	Bone GetSelectedBone();
+
+	void SetSkin(const SkinnedMesh &mesh);
+
+	/// replaces the rig, skin and recorded clip with the ones of a rig asset and calls Init,
+	/// returns false and keeps the scene as it is if the asset can not be loaded
+	bool LoadAsset(const std::string &path);
 
-	void SetSkin(const std::vector<Vertex> &skin);
+	/// saves the rig, skin and recorded clip as a rig asset
+	bool SaveAsset(const std::string &path) const;
 
 
 	void InverseKinematic();
 
+	void SwitchSolver();
+
 	void Animate(float deltaTime);
 
 
@@ -65,11 +73,12 @@ public:
 
 	void Update(float deltaTime);
 
+	/// legacy GL drawing, in SceneRender.cpp so everything else runs headless
 	void Render();
 
 
 	void SwitchMode() {
-		animationTime = 0;
+		if (animator != nullptr) animator->SetTime(0);
 		mode = (mode + 1) % 4;
 		std::cout << MODE_NAMES[mode] << " mode" << std::endl;
 	};
@@ -83,11 +92,22 @@ public:
 	int mode;
 
 private:
-	std::vector<Vertex> skin;
-	Skeleton *skeleton;
-	Bone *selectedBone;
-
-	float animationTime = 0;
-
-	std::vector<std::map<int, glm::quat> > keyframes;
+	SkinnedMesh mesh;
+	RigAsset asset;
+	Skinning skinning;
+	std::unique_ptr<ThreadPool> pool;
+	std::unique_ptr<Skeleton> skeleton;
+	std::unique_ptr<Pose> pose;
+	int selectedBone;
+
+	std::unique_ptr<AnimationStateMachine> animator; // made by Init
+	int toggleAction = -1;
+
+	IKChain ikChain;
+	FabrikSolver fabrik;
+	DlsSolver dls;
+	IKSolver *ikSolver = &dls;
+
+	AnimationClip clip;
+	ClipCursor cursor;
 };
\ No newline at end of file
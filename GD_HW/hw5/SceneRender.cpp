@@ -0,0 +1,45 @@
+#include <GL/glew.h>
+
+#include "Scene.h"
+
+// kept apart from Scene.cpp so the scene simulation builds without GL
+
+void Scene::Render() {
+	// Draw Origin
+	glColor3f(1, 0, 0);
+	glBegin(GL_LINES);
+	glVertex2f(-20, 0);
+	glVertex2f(20, 0);
+	glVertex2f(0, -20);
+	glVertex2f(0, 20);
+	glEnd();
+
+	// Draw Skeleton
+	for (int i = 0; i < GetBoneCount(); i++) {
+		glm::vec3 bone_start_point, bone_end_point, top_point(2, 2, 0), bottom_point(2, -2, 0);
+
+		auto bone = GetBone(i);
+
+		bone.calc_bone_point(bone_start_point, bone_end_point);
+		top_point = bone.transform_from_boneSpace(top_point);
+		bottom_point = bone.transform_from_boneSpace(bottom_point);
+
+		if (i == this->selectedBone) glLineWidth(4);
+		glColor3f(0, 1, 0);
+		glBegin(GL_LINE_LOOP);
+		glVertex2f(bone_start_point.x, bone_start_point.y);
+		glVertex2f(top_point.x, top_point.y);
+		glVertex2f(bone_end_point.x, bone_end_point.y);
+		glVertex2f(bottom_point.x, bottom_point.y);
+		glEnd();
+		glLineWidth(1);
+	}
+
+	// Draw Skin
+	glColor3f(0, 0, 1);
+	auto x = this->skinning.getX();
+	auto y = this->skinning.getY();
+	glBegin(GL_POINTS);
+	for (int i = 0; i < this->skinning.getVertexCount(); i++) glVertex2f(x[i], y[i]);
+	glEnd();
+}
\ No newline at end of file
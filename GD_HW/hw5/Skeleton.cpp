@@ -1,36 +1,40 @@
 #include "Skeleton.h"
 
-void Skeleton::addBone(Bone *parent, Bone *bone, glm::vec3 translate, glm::vec3 rotation) {
-	if (parent == nullptr) this->root = bone;
-	else {
-		parent->children.push_back(bone);
-		bone->parent = parent;
-
-		bone->Mi_p = glm::identity<glm::mat4>();
-		bone->Mi_p = glm::translate(bone->Mi_p, glm::vec3(parent->length, 0, 0));
-		bone->Mi_p = glm::rotate(bone->Mi_p, rotation.z, glm::vec3(0, 0, 1));
-		bone->Mi_p = glm::rotate(bone->Mi_p, rotation.y, glm::vec3(0, 1, 0));
-		bone->Mi_p = glm::rotate(bone->Mi_p, rotation.x, glm::vec3(1, 0, 0));
-		bone->Mi_p = glm::translate(bone->Mi_p, translate);
+int Skeleton::addBone(int parent, const std::string &bone_name, int length, glm::vec3 translate, glm::vec3 rotation) {
+	auto Mi_p_bone = glm::identity<glm::mat4>();
+	if (parent >= 0) {
+		Mi_p_bone = glm::translate(Mi_p_bone, glm::vec3(this->lengths[parent], 0, 0));
+		Mi_p_bone = glm::rotate(Mi_p_bone, rotation.z, glm::vec3(0, 0, 1));
+		Mi_p_bone = glm::rotate(Mi_p_bone, rotation.y, glm::vec3(0, 1, 0));
+		Mi_p_bone = glm::rotate(Mi_p_bone, rotation.x, glm::vec3(1, 0, 0));
+		Mi_p_bone = glm::translate(Mi_p_bone, translate);
 	}
-
-	this->BoneNames.push_back(bone->name);
-	this->Bones[bone->name] = bone;
+	return addBone(parent, bone_name, length, Mi_p_bone);
 }
 
-std::vector<std::string> Skeleton::getBoneNames() {
-	return BoneNames;
+int Skeleton::addBone(int parent, const std::string &bone_name, int length, const glm::mat4 &parentTransform) {
+	int bone = getBoneCount();
+	this->parents.push_back(parent);
+	this->lengths.push_back(length);
+	this->names.push_back(bone_name);
+	this->boneIndex[bone_name] = bone;
+
+	this->Mi_p.push_back(parentTransform);
+	this->Mi_d.emplace_back(1);
+	this->Mi_d_inv.emplace_back(1);
+
+	return bone;
 }
 
-Bone *Skeleton::getBone(const std::string &bone_name) {
-	if (this->Bones.count(bone_name) != 0) return this->Bones[bone_name];
-	else return nullptr;
+int Skeleton::findBone(const std::string &bone_name) const {
+	auto it = this->boneIndex.find(bone_name);
+	return it == this->boneIndex.end() ? -1 : it->second;
 }
 
 void Skeleton::calc_Mi_d() {
-	this->root->calc_Mi_d();
+	for (int i = 0; i < getBoneCount(); i++) {
+		auto parent = this->parents[i];
+		this->Mi_d[i] = parent < 0 ? glm::identity<glm::mat4>() : this->Mi_d[parent] * this->Mi_p[i];
+		this->Mi_d_inv[i] = glm::inverse(this->Mi_d[i]);
+	}
 }
-
-void Skeleton::calc_Mi_a() {
-	this->root->calc_Mi_a();
-}
\ No newline at end of file
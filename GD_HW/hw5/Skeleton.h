@@ -3,22 +3,49 @@
 #include <map>
 #include "Bone.h"
 
+/// shared rig definition, flat bone hierarchy with bind poses.
+/// bones live in arrays indexed by their handle, a parent is always added before its children
+/// so the arrays are topologically sorted and every pose pass is a single forward loop.
+/// once calc_Mi_d is done the skeleton is only read, animated state lives in Pose.
 class Skeleton {
 public:
 
-	void addBone(Bone *parent, Bone *bone, glm::vec3 translate, glm::vec3 rotation);
+	/// returns the new bone handle, parent is -1 for the root
+	int addBone(int parent, const std::string &bone_name, int length, glm::vec3 translate, glm::vec3 rotation);
 
-	std::vector<std::string> getBoneNames();
+	/// same with a ready boneSpace to parentSpace transform, for loading code
+	int addBone(int parent, const std::string &bone_name, int length, const glm::mat4 &parentTransform);
 
-	Bone *getBone(const std::string &bone_name);
+	/// name lookup for loading code, -1 when there is no such bone
+	[[nodiscard]] int findBone(const std::string &bone_name) const;
 
-	void calc_Mi_d();
+	[[nodiscard]] inline const std::vector<std::string> &getBoneNames() const { return this->names; }
+
+	[[nodiscard]] inline int getBoneCount() const { return (int) this->parents.size(); }
+
+	[[nodiscard]] inline int getParent(int bone) const { return this->parents[bone]; }
+
+	[[nodiscard]] inline int getLength(int bone) const { return this->lengths[bone]; }
+
+	[[nodiscard]] inline const std::string &getName(int bone) const { return this->names[bone]; }
 
-	void calc_Mi_a();
+	[[nodiscard]] inline const glm::mat4 &getParentTransform(int bone) const { return this->Mi_p[bone]; }
+
+	[[nodiscard]] inline const glm::mat4 &getBindPose(int bone) const { return this->Mi_d[bone]; }
+
+	[[nodiscard]] inline const glm::mat4 &getInverseBindPose(int bone) const { return this->Mi_d_inv[bone]; }
+
+	/// bind pose of all bones
+	void calc_Mi_d();
 
 private:
 
-	Bone *root;
-	std::vector<std::string> BoneNames;
-	std::map<std::string, Bone *> Bones;
-};
\ No newline at end of file
+	std::vector<int> parents;
+	std::vector<int> lengths;
+	std::vector<std::string> names;
+	std::map<std::string, int> boneIndex;
+
+	std::vector<glm::mat4> Mi_p; // boneSpace to parentSpace
+	std::vector<glm::mat4> Mi_d; // boneSpace to charSpace   					=>   Mi,dInv: charSpace(defPos) to boneSpace(defPos)
+	std::vector<glm::mat4> Mi_d_inv; // cached inverse of Mi_d, the bind pose only changes in calc_Mi_d
+};
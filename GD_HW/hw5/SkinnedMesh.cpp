@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <cmath>
+#include "SkinnedMesh.h"
+
+int SkinnedMesh::addVertex(const glm::vec2 &position, std::initializer_list<Influence> influences) {
+	// merge, heaviest first
+	Influence merged[16];
+	int count = 0;
+	for (auto &influence : influences) {
+		if (influence.weight <= 0) continue;
+		auto same = std::find_if(merged, merged + count, [&](const Influence &other) { return other.bone == influence.bone; });
+		if (same != merged + count) same->weight += influence.weight;
+		else if (count < 16) merged[count++] = influence;
+	}
+	std::sort(merged, merged + count, [](const Influence &a, const Influence &b) { return a.weight > b.weight; });
+	count = std::min(count, (int) MAX_INFLUENCES);
+
+	float sum = 0;
+	for (int k = 0; k < count; k++) sum += merged[k].weight;
+	if (count == 0) {
+		// no usable weight, follow the first listed bone
+		merged[count++] = Influence{influences.size() > 0 ? influences.begin()->bone : 0, 1};
+		sum = 1;
+	}
+
+	// quantize, the rounding error goes to the heaviest slot so the weights still sum to one
+	uint16_t quantized[MAX_INFLUENCES] = {};
+	int total = 0;
+	for (int k = 0; k < count; k++) {
+		quantized[k] = (uint16_t) std::lround(merged[k].weight / sum * 65535);
+		total += quantized[k];
+	}
+	quantized[0] = (uint16_t) (quantized[0] + 65535 - total);
+
+	const auto vertex = getVertexCount();
+	this->bind_x.push_back(position.x);
+	this->bind_y.push_back(position.y);
+	for (int k = 0; k < MAX_INFLUENCES; k++) {
+		this->bones.push_back(k < count ? (uint8_t) merged[k].bone : 0);
+		this->weights.push_back(quantized[k]);
+	}
+
+	if (vertex % BATCH_SIZE == 0) {
+		this->batchStart.push_back(this->batchStart.back());
+		this->batchInfluences.push_back(0);
+	}
+	const auto batchFirst = this->batchStart[this->batchStart.size() - 2];
+	for (int k = 0; k < count; k++) {
+		auto bone = (uint8_t) merged[k].bone;
+		if (std::find(this->batchBones.begin() + batchFirst, this->batchBones.end(), bone) != this->batchBones.end()) continue;
+		this->batchBones.push_back(bone);
+		this->batchStart.back()++;
+	}
+	this->batchInfluences.back() = std::max(this->batchInfluences.back(), (uint8_t) count);
+
+	return vertex;
+}
+
+/// skins count vertices of one batch, Slots is a template argument so the influence loop unrolls
+template<int Slots>
+static void skinBatch(const SkinMatrix *m, const uint8_t *bones, const uint16_t *weights,
+                      const float *__restrict ox, const float *__restrict oy,
+                      float *__restrict px, float *__restrict py, int count) {
+	const float unorm = 1.0f / 65535;
+	for (int i = 0; i < count; i++) {
+		const uint8_t *bi = bones + i * SkinnedMesh::MAX_INFLUENCES;
+		const uint16_t *wi = weights + i * SkinnedMesh::MAX_INFLUENCES;
+
+		// blended matrix, the only part that touches bone data
+		float a = 0, b = 0, c = 0, d = 0, tx = 0, ty = 0;
+		for (int k = 0; k < Slots; k++) {
+			auto &mk = m[bi[k]];
+			auto w = float(wi[k]) * unorm;
+			a += mk.a * w;
+			b += mk.b * w;
+			c += mk.c * w;
+			d += mk.d * w;
+			tx += mk.tx * w;
+			ty += mk.ty * w;
+		}
+
+		px[i] = a * ox[i] + c * oy[i] + tx;
+		py[i] = b * ox[i] + d * oy[i] + ty;
+	}
+}
+
+void SkinnedMeshView::skinRange(const SkinMatrix *m, float *x, float *y, int begin, int end) const {
+	const int BATCH_SIZE = SkinnedMesh::BATCH_SIZE;
+	for (int first = begin; first < end; first += BATCH_SIZE) {
+		const int count = std::min(BATCH_SIZE, end - first);
+		const uint8_t *bi = this->bones + (size_t) first * SkinnedMesh::MAX_INFLUENCES;
+		const uint16_t *wi = this->weights + (size_t) first * SkinnedMesh::MAX_INFLUENCES;
+		const float *ox = this->bind_x + first;
+		const float *oy = this->bind_y + first;
+
+		switch (this->batchInfluences[first / BATCH_SIZE]) {
+			case 1: skinBatch<1>(m, bi, wi, ox, oy, x + first, y + first, count); break;
+			case 2: skinBatch<2>(m, bi, wi, ox, oy, x + first, y + first, count); break;
+			case 3: skinBatch<3>(m, bi, wi, ox, oy, x + first, y + first, count); break;
+			default: skinBatch<4>(m, bi, wi, ox, oy, x + first, y + first, count); break;
+		}
+	}
+}
+
+SkinnedMeshView SkinnedMesh::getView() const {
+	return SkinnedMeshView{
+			getVertexCount(), (int) this->batchInfluences.size(),
+			this->bind_x.data(), this->bind_y.data(), this->bones.data(), this->weights.data(),
+			this->batchStart.data(), this->batchBones.data(), this->batchInfluences.data(),
+	};
+}
+
+size_t SkinnedMesh::getMemorySize() const {
+	return this->bind_x.size() * sizeof(float) + this->bind_y.size() * sizeof(float)
+	       + this->bones.size() * sizeof(uint8_t) + this->weights.size() * sizeof(uint16_t);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+#include <glm/glm.hpp>
+
+/// one bone influence of a vertex while building a mesh
+struct Influence {
+	int bone;
+	float weight;
+};
+
+/// 2D part of a bone skinning matrix, enough for this rig that only lives in the xy plane
+struct SkinMatrix {
+	float a, b; // x axis
+	float c, d; // y axis
+	float tx, ty;
+};
+
+/// read only skinned mesh data, owned by a SkinnedMesh or mapped in place from a RigAsset.
+/// batch i reads batchBones[batchStart[i] .. batchStart[i + 1]] and fills its first batchInfluences[i] slots
+struct SkinnedMeshView {
+	int vertexCount = 0;
+	int batchCount = 0;
+	const float *bind_x = nullptr;
+	const float *bind_y = nullptr;
+	const uint8_t *bones = nullptr;    // vertex * MAX_INFLUENCES + slot
+	const uint16_t *weights = nullptr; // vertex * MAX_INFLUENCES + slot, unorm16
+	const int32_t *batchStart = nullptr;
+	const uint8_t *batchBones = nullptr;
+	const uint8_t *batchInfluences = nullptr;
+
+	[[nodiscard]] inline int getBatchBoneCount(int batch) const {
+		return this->batchStart[batch + 1] - this->batchStart[batch];
+	}
+
+	[[nodiscard]] inline const uint8_t *getBatchBones(int batch) const {
+		return this->batchBones + this->batchStart[batch];
+	}
+
+	/// skins vertices [begin, end) into x and y with the given bone matrices, begin must start a batch
+	void skinRange(const SkinMatrix *m, float *x, float *y, int begin, int end) const;
+};
+
+/// immutable bind pose of a skinned mesh, laid out like the vertex buffers a GPU skinning shader would read.
+/// positions are SoA floats, every vertex has MAX_INFLUENCES uint8 bone indices and unorm16 weights that sum to one,
+/// unused slots have weight zero. the skinned output lives elsewhere, so one mesh serves many instances.
+/// vertices are grouped in batches that know the bones they read and how many slots they use,
+/// so a mesh of two bone vertices does not pay for four.
+class SkinnedMesh {
+public:
+	static const int MAX_INFLUENCES = 4;
+	static const int BATCH_SIZE = 256;
+
+	/// merges influences of the same bone, keeps the heaviest MAX_INFLUENCES and renormalizes them.
+	/// bone indices must be below 256, returns the vertex index
+	int addVertex(const glm::vec2 &position, std::initializer_list<Influence> influences);
+
+	[[nodiscard]] inline int getVertexCount() const { return (int) this->bind_x.size(); }
+
+	/// valid until the next addVertex
+	[[nodiscard]] SkinnedMeshView getView() const;
+
+	/// bytes of bind data, to compare against other vertex layouts
+	[[nodiscard]] size_t getMemorySize() const;
+
+private:
+
+	std::vector<float> bind_x;
+	std::vector<float> bind_y;
+	std::vector<uint8_t> bones;
+	std::vector<uint16_t> weights;
+
+	std::vector<int32_t> batchStart = {0};
+	std::vector<uint8_t> batchBones;
+	std::vector<uint8_t> batchInfluences;
+};
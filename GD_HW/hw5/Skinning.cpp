@@ -0,0 +1,79 @@
+#include <algorithm>
+#include "Skinning.h"
+
+void Skinning::setMesh(const SkinnedMeshView &newMesh) {
+	this->mesh = newMesh;
+	this->x.assign(newMesh.vertexCount, 0);
+	this->y.assign(newMesh.vertexCount, 0);
+
+	// a new mesh has never been skinned with the current matrices
+	this->matrices.clear();
+}
+
+static SkinMatrix toSkinMatrix(const glm::mat4 &Mi) {
+	// vertices are skinned as (x, y, 1, 1), so the z column folds into the translation
+	return SkinMatrix{
+			Mi[0][0], Mi[0][1],
+			Mi[1][0], Mi[1][1],
+			Mi[2][0] + Mi[3][0], Mi[2][1] + Mi[3][1],
+	};
+}
+
+void Skinning::calcMatrices(const Pose &pose, SkinMatrix *matrices) {
+	const auto boneCount = pose.getBoneCount();
+	for (int i = 0; i < boneCount; i++) {
+		matrices[i] = toSkinMatrix(pose.getSkinningMatrix(i));
+	}
+}
+
+void Skinning::updateMatrices(const Pose &pose) {
+	const auto boneCount = pose.getBoneCount();
+	if ((int) this->matrices.size() != boneCount) {
+		this->matrices.resize(boneCount);
+		calcMatrices(pose, this->matrices.data());
+		this->dirtyBones.assign(boneCount, 1);
+		this->anyDirty = true;
+		return;
+	}
+
+	if (!pose.hasMoved()) return;
+	for (int i = 0; i < boneCount; i++) {
+		if (!pose.isMoved(i)) continue;
+		this->matrices[i] = toSkinMatrix(pose.getSkinningMatrix(i));
+		this->dirtyBones[i] = 1;
+		this->anyDirty = true;
+	}
+}
+
+void Skinning::skin(ThreadPool *pool) {
+	if (!this->anyDirty) return;
+
+	const auto n = getVertexCount();
+	this->dirtyBatches.clear();
+	for (int batch = 0; batch < this->mesh.batchCount; batch++) {
+		auto bones = this->mesh.getBatchBones(batch);
+		for (int j = 0; j < this->mesh.getBatchBoneCount(batch); j++) {
+			if (this->dirtyBones[bones[j]]) {
+				this->dirtyBatches.push_back(batch);
+				break;
+			}
+		}
+	}
+	std::fill(this->dirtyBones.begin(), this->dirtyBones.end(), 0);
+	this->anyDirty = false;
+
+	auto skinBatches = [this, n](int begin, int end) {
+		for (int j = begin; j < end; j++) {
+			const auto first = this->dirtyBatches[j] * SkinnedMesh::BATCH_SIZE;
+			const auto last = std::min(n, first + SkinnedMesh::BATCH_SIZE);
+			this->mesh.skinRange(this->matrices.data(), this->x.data(), this->y.data(), first, last);
+		}
+	};
+
+	const auto dirtyCount = (int) this->dirtyBatches.size();
+	if (pool == nullptr) {
+		skinBatches(0, dirtyCount);
+		return;
+	}
+	pool->parallelFor(dirtyCount, THREAD_GRAIN / SkinnedMesh::BATCH_SIZE, skinBatches);
+}
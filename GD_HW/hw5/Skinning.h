@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+#include "Pose.h"
+#include "SkinnedMesh.h"
+#include "ThreadPool.h"
+
+/// linear blend skinning of one instance of a shared mesh into its own output buffer.
+/// skinning matrices are computed once per bone per frame and the blend runs in the mesh batches,
+/// spread over a thread pool. only batches that read a bone that moved get skinned again.
+class Skinning {
+public:
+	static const int THREAD_GRAIN = 16 * SkinnedMesh::BATCH_SIZE;
+
+	/// the mesh data is shared and must outlive this skinning
+	void setMesh(const SkinnedMeshView &mesh);
+
+	/// Mi_a * inverse(Mi_d) of every bone of the pose, the inverse bind pose is cached by Skeleton::calc_Mi_d
+	static void calcMatrices(const Pose &pose, SkinMatrix *matrices);
+
+	/// refreshes the matrices of the bones that moved in pose (all of them the first time)
+	void updateMatrices(const Pose &pose);
+
+	/// skins the batches that read a refreshed bone, pool may be null to run on the calling thread
+	void skin(ThreadPool *pool);
+
+	[[nodiscard]] inline const SkinnedMeshView &getMesh() const { return this->mesh; }
+
+	[[nodiscard]] inline int getVertexCount() const { return (int) this->x.size(); }
+
+	[[nodiscard]] inline const float *getX() const { return this->x.data(); }
+
+	[[nodiscard]] inline const float *getY() const { return this->y.data(); }
+
+private:
+
+	SkinnedMeshView mesh;
+
+	std::vector<SkinMatrix> matrices;
+	std::vector<char> dirtyBones;
+	bool anyDirty = false;
+	std::vector<int> dirtyBatches;
+
+	// skinned
+	std::vector<float> x;
+	std::vector<float> y;
+};
@@ -0,0 +1,69 @@
+#include <algorithm>
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int workerCount) {
+	if (workerCount < 0)
+		workerCount = std::max(0, (int) std::thread::hardware_concurrency() - 1);
+
+	for (int i = 0; i < workerCount; i++)
+		this->workers.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->stopping = true;
+	}
+	this->startCondition.notify_all();
+	for (auto &worker : this->workers) worker.join();
+}
+
+void ThreadPool::run(int jobCount, int jobGrain, void (*jobTask)(void *, int, int), void *jobContext) {
+	if (jobCount <= 0) return;
+	jobGrain = std::max(1, jobGrain);
+
+	// not worth waking anyone up
+	if (this->workers.empty() || jobCount <= jobGrain) {
+		jobTask(jobContext, 0, jobCount);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->task = jobTask;
+		this->context = jobContext;
+		this->count = jobCount;
+		this->grain = jobGrain;
+		this->next = 0;
+		this->busyWorkers = (int) this->workers.size();
+		this->generation++;
+	}
+	this->startCondition.notify_all();
+
+	work();
+
+	std::unique_lock<std::mutex> lock(this->mutex);
+	this->doneCondition.wait(lock, [this]() { return this->busyWorkers == 0; });
+}
+
+void ThreadPool::work() {
+	for (int begin; (begin = this->next.fetch_add(this->grain)) < this->count;)
+		this->task(this->context, begin, std::min(this->count, begin + this->grain));
+}
+
+void ThreadPool::workerLoop() {
+	unsigned int seenGeneration = 0;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->startCondition.wait(lock, [&]() { return this->stopping || this->generation != seenGeneration; });
+			if (this->stopping) return;
+			seenGeneration = this->generation;
+		}
+
+		work();
+
+		std::lock_guard<std::mutex> lock(this->mutex);
+		if (--this->busyWorkers == 0) this->doneCondition.notify_one();
+	}
+}
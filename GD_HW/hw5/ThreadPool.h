@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/// fixed set of worker threads for data parallel loops.
+/// the calling thread takes part in the work, so a pool of 0 workers simply runs inline.
+class ThreadPool {
+public:
+
+	/// workers == -1 uses one worker per hardware thread (besides the caller)
+	explicit ThreadPool(int workers = -1);
+
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool &) = delete;
+
+	ThreadPool &operator=(const ThreadPool &) = delete;
+
+	/// number of threads a loop is split over, including the caller
+	[[nodiscard]] inline int getThreadCount() const { return (int) this->workers.size() + 1; }
+
+	/// calls fn(begin, end) over [0, count) in chunks of `grain`, returns when all chunks are done
+	template<class Fn>
+	void parallelFor(int count, int grain, Fn &&fn) {
+		using Task = std::remove_reference_t<Fn>;
+		run(count, grain, [](void *context, int begin, int end) {
+			(*(Task *) context)(begin, end);
+		}, (void *) &fn);
+	}
+
+private:
+
+	void run(int count, int grain, void (*task)(void *, int, int), void *context);
+
+	void work();
+
+	void workerLoop();
+
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable startCondition;
+	std::condition_variable doneCondition;
+
+	// current job
+	void (*task)(void *, int, int) = nullptr;
+	void *context = nullptr;
+	int count = 0;
+	int grain = 1;
+	std::atomic<int> next{0};
+	int busyWorkers = 0;
+	unsigned int generation = 0;
+	bool stopping = false;
+};
@@ -0,0 +1,62 @@
+#include <algorithm>
+#include "BodyTree.h"
+
+void BodyTree::Build(const std::vector<Body2D *> &bodies, const std::vector<int> &subset) {
+	const auto n = (int) subset.size();
+
+	nodes.clear();
+	items.assign(subset.begin(), subset.end());
+	boxes.resize(bodies.size());
+	centers.resize(bodies.size());
+	if (n == 0) return;
+
+	for (auto i : items) {
+		boxes[i] = bodies[i]->GetAABB();
+		centers[i] = boxes[i].GetCenter();
+	}
+
+	// a binary tree never has more than 2n - 1 nodes, so Subdivide never reallocates
+	nodes.reserve(2 * n);
+	nodes.push_back(Node{});
+	Subdivide(0, 0, n);
+}
+
+void BodyTree::Subdivide(int node, int first, int count) {
+	auto box = boxes[items[first]];
+	auto centerBox = AABB{centers[items[first]], centers[items[first]]};
+	for (int i = first + 1; i < first + count; i++) {
+		box = box.Union(boxes[items[i]]);
+		centerBox = centerBox.Union(AABB{centers[items[i]], centers[items[i]]});
+	}
+	nodes[node].box = box;
+
+	if (count <= LEAF_SIZE) {
+		nodes[node].first = first;
+		nodes[node].count = count;
+		return;
+	}
+
+	// median split along the longest axis keeps the tree balanced
+	auto size = centerBox.max - centerBox.min;
+	int axis = size.x > size.y ? 0 : 1;
+	int mid = first + count / 2;
+	std::nth_element(items.begin() + first, items.begin() + mid, items.begin() + first + count,
+									 [&](int a, int b) { return centers[a][axis] < centers[b][axis]; });
+
+	int child = (int) nodes.size();
+	nodes.push_back(Node{});
+	nodes.push_back(Node{});
+	nodes[node].first = child;
+	nodes[node].count = 0;
+
+	Subdivide(child, first, mid - first);
+	Subdivide(child + 1, mid, first + count - mid);
+}
+
+bool BodyTree::RayOverlaps(const AABB &box, glm::vec2 origin, glm::vec2 invDir, float maxDistance) {
+	auto t1 = (box.min - origin) * invDir;
+	auto t2 = (box.max - origin) * invDir;
+	auto tMin = glm::max(glm::min(t1.x, t2.x), glm::min(t1.y, t2.y));
+	auto tMax = glm::min(glm::max(t1.x, t2.x), glm::max(t1.y, t2.y));
+	return tMax >= glm::max(tMin, 0.0f) && tMin <= maxDistance;
+}
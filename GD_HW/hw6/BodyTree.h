@@ -0,0 +1,94 @@
+#pragma once
+
+#include <vector>
+#include "Box2D.h"
+#include "CollisionDetector.h"
+
+/// bounding volume hierarchy over the bounds of a body list.
+/// it is rebuilt from scratch whenever bodies change, nodes and items live in flat
+/// arrays so a rebuild reuses the storage of the previous one.
+class BodyTree {
+public:
+	static const int LEAF_SIZE = 4;
+	static const int MAX_DEPTH = 64;
+
+	/// builds the tree over `subset`, visitors receive indices into `bodies`
+	void Build(const std::vector<Body2D *> &bodies, const std::vector<int> &subset);
+
+	[[nodiscard]]
+	inline bool IsEmpty() const { return nodes.empty(); }
+
+	/// calls visitor(index) for each body whose bounds overlap `box`
+	template<class Visitor>
+	void Query(const AABB &box, Visitor visitor) const;
+
+	/// calls visitor(index, maxDistance) for each body whose bounds (grown by `radius`) the ray passes,
+	/// the visitor may shrink maxDistance to prune everything behind the closest hit found so far
+	template<class Visitor>
+	void Query(const Ray2D &ray, float radius, Visitor visitor) const;
+
+private:
+	struct Node {
+		AABB box;
+		int first; // first child for inner nodes, first item for leaves
+		int count; // 0 for inner nodes
+	};
+
+	void Subdivide(int node, int first, int count);
+
+	static bool RayOverlaps(const AABB &box, glm::vec2 origin, glm::vec2 invDir, float maxDistance);
+
+	std::vector<Node> nodes;
+	std::vector<int> items;
+	std::vector<AABB> boxes;
+	std::vector<glm::vec2> centers;
+};
+
+template<class Visitor>
+void BodyTree::Query(const AABB &box, Visitor visitor) const {
+	if (nodes.empty()) return;
+
+	int stack[MAX_DEPTH];
+	int top = 0;
+	stack[top++] = 0;
+
+	while (top > 0) {
+		auto &node = nodes[stack[--top]];
+		if (!node.box.Overlaps(box)) continue;
+
+		if (node.count == 0) {
+			stack[top++] = node.first;
+			stack[top++] = node.first + 1;
+		} else {
+			for (int i = node.first; i < node.first + node.count; i++)
+				if (boxes[items[i]].Overlaps(box)) visitor(items[i]);
+		}
+	}
+}
+
+template<class Visitor>
+void BodyTree::Query(const Ray2D &ray, float radius, Visitor visitor) const {
+	if (nodes.empty()) return;
+
+	auto grow = glm::vec2(radius);
+	auto inverse = [](float d) { return glm::abs(d) < 1e-12f ? 1e30f : 1 / d; };
+	auto invDir = glm::vec2(inverse(ray.direction.x), inverse(ray.direction.y));
+	float maxDistance = ray.maxDistance;
+
+	int stack[MAX_DEPTH];
+	int top = 0;
+	stack[top++] = 0;
+
+	while (top > 0) {
+		auto &node = nodes[stack[--top]];
+		if (!RayOverlaps(AABB{node.box.min - grow, node.box.max + grow}, ray.origin, invDir, maxDistance)) continue;
+
+		if (node.count == 0) {
+			stack[top++] = node.first;
+			stack[top++] = node.first + 1;
+		} else {
+			for (int i = node.first; i < node.first + node.count; i++)
+				visitor(items[i], maxDistance);
+		}
+	}
+}
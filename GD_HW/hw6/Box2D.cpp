@@ -69,6 +69,15 @@ std::vector<glm::vec2> Box2D::GetVertices(bool lite) const {
 	return result;
 }
 
+AABB Box2D::GetAABB() const {
+	auto c = glm::abs(glm::cos(this->angle));
+	auto s = glm::abs(glm::sin(this->angle));
+	auto hw = this->shape.width / 2;
+	auto hh = this->shape.height / 2;
+	auto extent = glm::vec2(c * hw + s * hh, s * hw + c * hh);
+	return AABB{position - extent, position + extent};
+}
+
 glm::vec2 Box2D::GetCentroid() const {
 	glm::vec2 centroid(0);
 	auto vertices = GetVertices(true);
@@ -96,3 +105,8 @@ std::vector<glm::vec2> Circle2D::GetVertices(bool lite) const {
 
 	return result;
 }
+
+AABB Circle2D::GetAABB() const {
+	auto extent = glm::vec2(shape.radius);
+	return AABB{position - extent, position + extent};
+}
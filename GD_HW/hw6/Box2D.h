@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vector>
+#include <cstdint>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
@@ -12,6 +13,30 @@ enum class BodyType {
 	Box, Circle,
 };
 
+struct AABB {
+	glm::vec2 min;
+	glm::vec2 max;
+
+	[[nodiscard]]
+	inline bool Overlaps(const AABB &other) const {
+		return min.x <= other.max.x && other.min.x <= max.x &&
+					 min.y <= other.max.y && other.min.y <= max.y;
+	}
+
+	[[nodiscard]]
+	inline bool Contains(glm::vec2 p) const {
+		return min.x <= p.x && p.x <= max.x && min.y <= p.y && p.y <= max.y;
+	}
+
+	[[nodiscard]]
+	inline AABB Union(const AABB &other) const {
+		return AABB{glm::min(min, other.min), glm::max(max, other.max)};
+	}
+
+	[[nodiscard]]
+	inline glm::vec2 GetCenter() const { return (min + max) * 0.5f; }
+};
+
 struct Shape {
 	Shape(float mass, float momentOfInertia) :
 			mass(mass), momentOfInertia(momentOfInertia) {}
@@ -43,7 +68,11 @@ public:
 	explicit Body2D(CollisionType type = CollisionType::External) :
 			position(0), linearVelocity(0), force(0),
 			angle(0), angularVelocity(0), torque(0),
-			collisionType(type) {}
+			collisionType(type),
+			categoryBits(0x0001), maskBits(0xFFFF),
+			isSensor(false) {}
+
+	virtual ~Body2D() = default;
 
 	[[nodiscard]]
 	inline virtual Shape &GetShape() = 0;
@@ -54,6 +83,29 @@ public:
 	[[nodiscard]]
 	inline CollisionType GetCollisionType() const { return this->collisionType; }
 
+	/// `category` are the layers this body is on, `mask` the layers it collides with
+	inline void SetFilter(uint16_t category, uint16_t mask) {
+		this->categoryBits = category;
+		this->maskBits = mask;
+	}
+
+	[[nodiscard]]
+	inline uint16_t GetCategoryBits() const { return this->categoryBits; }
+
+	[[nodiscard]]
+	inline uint16_t GetMaskBits() const { return this->maskBits; }
+
+	[[nodiscard]]
+	inline bool ShouldCollide(const Body2D *other) const {
+		return (this->categoryBits & other->maskBits) != 0 && (this->maskBits & other->categoryBits) != 0;
+	}
+
+	/// sensors are never resolved, they only report trigger enter / exit events
+	inline void SetSensor(bool sensor) { this->isSensor = sensor; }
+
+	[[nodiscard]]
+	inline bool IsSensor() const { return this->isSensor; }
+
 
 	void MoveTo(float x, float y, bool relative = false);
 
@@ -73,6 +125,10 @@ public:
 	[[nodiscard]]
 	virtual std::vector<glm::vec2> GetVertices(bool lite) const { return std::vector<glm::vec2>(); }
 
+	/// world space bounds, computed without building the vertex list
+	[[nodiscard]]
+	virtual AABB GetAABB() const { return AABB{position, position}; }
+
 	[[nodiscard]]
 	inline glm::vec2 GetPosition() const { return this->position; }
 
@@ -109,6 +165,10 @@ protected:
 	float torque;
 
 	CollisionType collisionType;
+
+	uint16_t categoryBits;
+	uint16_t maskBits;
+	bool isSensor;
 };
 
 
@@ -122,6 +182,9 @@ public:
 	[[nodiscard]]
 	std::vector<glm::vec2> GetVertices(bool lite) const override;
 
+	[[nodiscard]]
+	AABB GetAABB() const override;
+
 
 	[[nodiscard]]
 	inline Shape &GetShape() override { return shape; }
@@ -129,6 +192,12 @@ public:
 	[[nodiscard]]
 	inline BodyType GetBodyType() const override { return BodyType::Box; }
 
+	[[nodiscard]]
+	inline float GetWidth() const { return shape.width; }
+
+	[[nodiscard]]
+	inline float GetHeight() const { return shape.height; }
+
 private:
 	BoxShape shape;
 };
@@ -141,6 +210,9 @@ public:
 	[[nodiscard]]
 	std::vector<glm::vec2> GetVertices(bool lite) const override;
 
+	[[nodiscard]]
+	AABB GetAABB() const override;
+
 	[[nodiscard]]
 	inline Shape &GetShape() override { return shape; }
 
@@ -5,22 +5,14 @@ bool CollisionDetector::ShapeContainsPoint(Body2D *body, glm::vec2 v) {
 		return glm::length(v - body->GetCentroid()) < ((Circle2D *) body)->GetRadius();
 	}
 
-	auto vertices = ((Box2D *) body)->GetVertices(true);
-	auto n1 = vertices.size();
-
-	for (int i = 0; i < n1; i++) {
-		auto a = vertices[i];
-		auto b = vertices[(i + 1) % n1];
-
-		auto n = GetEdgeNormal(a - b);
-
-		bool isShapeInFrontOfEdge = true;
-
-		if (glm::dot(v - a, n) > 0)
-			return false;
-	}
-
-	return true;
+	// test in box space, no need to build the vertex list
+	auto box = (Box2D *) body;
+	auto d = v - box->GetPosition();
+	auto c = glm::cos(box->GetAngle());
+	auto s = glm::sin(box->GetAngle());
+	auto local = glm::vec2(c * d.x + s * d.y, -s * d.x + c * d.y);
+
+	return glm::abs(local.x) <= box->GetWidth() / 2 && glm::abs(local.y) <= box->GetHeight() / 2;
 }
 
 glm::vec2 CollisionDetector::ProjectToEdge(glm::vec2 v1, glm::vec2 v2, glm::vec2 p) {
@@ -49,6 +41,107 @@ bool CollisionDetector::IsPointBetweenTwoPoint(glm::vec2 v1, glm::vec2 v2, glm::
 	return glm::dot(e1, e2) > 0 && glm::dot(e1, e3) < 0;
 }
 
+static bool RayCastCircle(glm::vec2 center, float radius, bool isInternal, const Ray2D &ray,
+													float &t, glm::vec2 &normal) {
+	if (radius <= 0) return false;
+
+	auto m = ray.origin - center;
+	auto b = glm::dot(m, ray.direction);
+	auto c = glm::dot(m, m) - radius * radius;
+	auto disc = b * b - c;
+
+	if (disc < 0) return false;
+
+	if (isInternal) {
+		t = -b + glm::sqrt(disc); // leaving the inner area
+		if (t < 0) return false;
+		normal = -glm::normalize(m + t * ray.direction);
+	} else {
+		if (c < 0) return false; // started inside
+		t = -b - glm::sqrt(disc);
+		if (t < 0) return false;
+		normal = glm::normalize(m + t * ray.direction);
+	}
+	return t <= ray.maxDistance;
+}
+
+static bool RayCastBox(Box2D *box, bool isInternal, const Ray2D &ray, float radius, float &t, glm::vec2 &normal) {
+	// move the ray to box space
+	auto c = glm::cos(box->GetAngle());
+	auto s = glm::sin(box->GetAngle());
+	auto o = ray.origin - box->GetPosition();
+	auto origin = glm::vec2(c * o.x + s * o.y, -s * o.x + c * o.y);
+	auto dir = glm::vec2(c * ray.direction.x + s * ray.direction.y, -s * ray.direction.x + c * ray.direction.y);
+
+	auto half = glm::vec2(box->GetWidth() / 2, box->GetHeight() / 2);
+	auto extent = half + glm::vec2(isInternal ? -radius : radius);
+	if (extent.x <= 0 || extent.y <= 0) return false;
+
+	float tMin = -1e30f, tMax = 1e30f;
+	int minAxis = -1, maxAxis = -1;
+	float minSign = 0, maxSign = 0;
+
+	for (int axis = 0; axis < 2; axis++) {
+		if (glm::abs(dir[axis]) < 1e-8f) {
+			if (origin[axis] < -extent[axis] || origin[axis] > extent[axis]) return false;
+			continue;
+		}
+		auto inv = 1 / dir[axis];
+		auto t1 = (-extent[axis] - origin[axis]) * inv;
+		auto t2 = (extent[axis] - origin[axis]) * inv;
+		auto sign = -1.0f; // side the ray enters from
+		if (t1 > t2) {
+			std::swap(t1, t2);
+			sign = 1;
+		}
+		if (t1 > tMin) tMin = t1, minAxis = axis, minSign = sign;
+		if (t2 < tMax) tMax = t2, maxAxis = axis, maxSign = -sign;
+		if (tMin > tMax) return false;
+	}
+
+	glm::vec2 localNormal(0);
+	if (isInternal) {
+		if (tMax < 0 || maxAxis < 0) return false;
+		t = tMax;
+		localNormal[maxAxis] = -maxSign;
+	} else {
+		if (tMin < 0 || minAxis < 0) return false; // started inside
+		t = tMin;
+		localNormal[minAxis] = minSign;
+
+		// swept circles are tested against the rounded box, corners are circles
+		auto p = origin + t * dir;
+		if (radius > 0 && glm::abs(p.x) > half.x && glm::abs(p.y) > half.y) {
+			auto corner = glm::vec2(p.x > 0 ? half.x : -half.x, p.y > 0 ? half.y : -half.y);
+			if (!RayCastCircle(corner, radius, false, Ray2D{origin, dir, ray.maxDistance}, t, localNormal))
+				return false;
+		}
+	}
+	if (t > ray.maxDistance) return false;
+
+	normal = glm::vec2(c * localNormal.x - s * localNormal.y, s * localNormal.x + c * localNormal.y);
+	return true;
+}
+
+bool CollisionDetector::RayCast(Body2D *body, const Ray2D &ray, float radius, RayHit &hit) {
+	bool isInternal = body->GetCollisionType() == CollisionType::Internal;
+	float t;
+	glm::vec2 normal;
+
+	bool isHit;
+	if (body->GetBodyType() == BodyType::Circle) {
+		auto r = ((Circle2D *) body)->GetRadius();
+		isHit = RayCastCircle(body->GetPosition(), isInternal ? r - radius : r + radius, isInternal, ray, t, normal);
+	} else {
+		isHit = RayCastBox((Box2D *) body, isInternal, ray, radius, t, normal);
+	}
+
+	if (!isHit) return false;
+
+	hit = RayHit{body, ray.origin + t * ray.direction - radius * normal, normal, t, true};
+	return true;
+}
+
 CollisionInfo CollisionDetector::Detect(Body2D *body1, Circle2D *body2) const {
 	CollisionInfo info({body1, body2, glm::vec2(0), glm::vec2(0), glm::vec2(0), 0, false});
 
@@ -225,9 +318,132 @@ CollisionInfo CollisionDetector::Detect(Body2D *body1, Body2D *body2) const {
 	return info;
 }
 
-std::vector<CollisionInfo> CollisionDetector::Detect(std::vector<Body2D *> *bodies) const {
+bool CollisionDetector::DetectPair(Body2D *body1, Body2D *body2, CollisionInfo &info) const {
+	static const float EPS = 1e-5;
+
+	CollisionInfo collision_info_1;
+	CollisionInfo collision_info_2;
+
+	if (body1->GetBodyType() == BodyType::Circle && body2->GetBodyType() == BodyType::Circle) {
+		collision_info_1 = Detect((Circle2D *) body1, (Circle2D *) body2);
+		collision_info_2 = Detect((Circle2D *) body2, (Circle2D *) body1);
+//	} else if (body1->GetBodyType() == BodyType::Box) {
+//		collision_info_1 = Detect((Box2D *) body1, (Circle2D *) body2);
+//		collision_info_2 = Detect((Circle2D *) body2, (Box2D *) body1);
+//	} else if (body2->GetBodyType() == BodyType::Box) {
+//		collision_info_1 = Detect((Circle2D *) body1, (Box2D *) body2);
+//		collision_info_2 = Detect((Box2D *) body2, (Circle2D *) body1);
+	} else {
+		collision_info_1 = Detect((Box2D *) body1, (Box2D *) body2);
+		collision_info_2 = Detect((Box2D *) body2, (Box2D *) body1);
+	}
+
+	bool isInternal = collision_info_1.body1->GetCollisionType() == CollisionType::Internal;
+
+	if (collision_info_1.isCollided && (isInternal || collision_info_2.isCollided)) {
+		auto pd1 = collision_info_1.penetrationDepth;
+		auto pd2 = isInternal ? 1E6f : collision_info_2.penetrationDepth;
+
+		if (glm::min(pd1, pd2) < EPS) return false;
+
+		info = pd1 < pd2 ? collision_info_1 : collision_info_2;
+		return true;
+	}
+
+	return false;
+}
+
+static void GetBoxCorners(Box2D *box, glm::vec2 corners[4]) {
+	auto c = glm::cos(box->GetAngle());
+	auto s = glm::sin(box->GetAngle());
+	auto hw = box->GetWidth() / 2;
+	auto hh = box->GetHeight() / 2;
+	auto position = box->GetPosition();
+
+	// same order as BoxShape::vertices
+	const glm::vec2 local[4] = {{-hw, -hh}, {hw, -hh}, {hw, hh}, {-hw, hh}};
+	for (int i = 0; i < 4; i++)
+		corners[i] = position + glm::vec2(c * local[i].x - s * local[i].y, s * local[i].x + c * local[i].y);
+}
+
+static bool DetectInCircle(Circle2D *boundary, Box2D *body, CollisionInfo &info) {
+	auto c = boundary->GetPosition();
+	auto r = boundary->GetRadius();
+
+	glm::vec2 corners[4];
+	GetBoxCorners(body, corners);
+
+	info = CollisionInfo{boundary, body, glm::vec2(0), glm::vec2(0), glm::vec2(0), 0, false};
+	for (auto corner : corners) {
+		auto diff = corner - c;
+		auto dist = glm::length(diff);
+		if (dist - r > info.penetrationDepth) {
+			auto dir = diff / dist;
+			info = CollisionInfo{boundary, body, corner, c + r * dir, dir, dist - r, true};
+		}
+	}
+	return info.isCollided;
+}
+
+static bool DetectInBox(Box2D *boundary, Body2D *body, CollisionInfo &info) {
+	auto c = glm::cos(boundary->GetAngle());
+	auto s = glm::sin(boundary->GetAngle());
+	auto position = boundary->GetPosition();
+	auto half = glm::vec2(boundary->GetWidth() / 2, boundary->GetHeight() / 2);
+
+	auto toLocal = [&](glm::vec2 v) {
+		v -= position;
+		return glm::vec2(c * v.x + s * v.y, -s * v.x + c * v.y);
+	};
+	auto toWorld = [&](glm::vec2 v) {
+		return position + glm::vec2(c * v.x - s * v.y, s * v.x + c * v.y);
+	};
+
+	info = CollisionInfo{boundary, body, glm::vec2(0), glm::vec2(0), glm::vec2(0), 0, false};
+
+	if (body->GetBodyType() == BodyType::Circle) {
+		auto r = ((Circle2D *) body)->GetRadius();
+		auto center = toLocal(body->GetPosition());
+		auto inner = glm::max(half - glm::vec2(r), glm::vec2(0));
+		auto overflow = center - glm::clamp(center, -inner, inner);
+		auto depth = glm::length(overflow);
+		if (depth <= 0) return false;
+
+		auto dir = overflow / depth;
+		auto penetration = center + r * dir;
+		info = CollisionInfo{boundary, body, toWorld(penetration), toWorld(penetration - overflow),
+												 toWorld(dir) - position, depth, true};
+		return true;
+	}
+
+	glm::vec2 corners[4];
+	GetBoxCorners((Box2D *) body, corners);
+	for (auto corner : corners) {
+		auto local = toLocal(corner);
+		auto inside = glm::clamp(local, -half, half);
+		auto depth = glm::length(local - inside);
+		if (depth > info.penetrationDepth) {
+			info = CollisionInfo{boundary, body, corner, toWorld(inside), (toWorld(local - inside) - position) / depth,
+													 depth, true};
+		}
+	}
+	return info.isCollided;
+}
+
+bool CollisionDetector::DetectStatic(Body2D *boundary, Body2D *body, CollisionInfo &info) const {
 	static const float EPS = 1e-5;
 
+	if (boundary->GetBodyType() == BodyType::Box)
+		DetectInBox((Box2D *) boundary, body, info);
+	else if (body->GetBodyType() == BodyType::Circle)
+		info = Detect((Circle2D *) boundary, (Circle2D *) body);
+	else
+		DetectInCircle((Circle2D *) boundary, (Box2D *) body, info);
+
+	return info.isCollided && info.penetrationDepth >= EPS;
+}
+
+std::vector<CollisionInfo> CollisionDetector::Detect(std::vector<Body2D *> *bodies) const {
 	std::vector<CollisionInfo> result;
 
 	if (bodies->size() < 2) return result;
@@ -236,37 +452,11 @@ std::vector<CollisionInfo> CollisionDetector::Detect(std::vector<Body2D *> *bodi
 		auto body1 = (*bodies)[i];
 		for (int j = i + 1; j < bodies->size(); j++) {
 			auto body2 = (*bodies)[j];
+			if (!body1->ShouldCollide(body2)) continue;
 
-			CollisionInfo collision_info_1;
-			CollisionInfo collision_info_2;
-
-			if (body1->GetBodyType() == BodyType::Circle && body2->GetBodyType() == BodyType::Circle) {
-				collision_info_1 = Detect((Circle2D *) body1, (Circle2D *) body2);
-				collision_info_2 = Detect((Circle2D *) body2, (Circle2D *) body1);
-//			} else if (body1->GetBodyType() == BodyType::Box) {
-//				collision_info_1 = Detect((Box2D *) body1, (Circle2D *) body2);
-//				collision_info_2 = Detect((Circle2D *) body2, (Box2D *) body1);
-//			} else if (body2->GetBodyType() == BodyType::Box) {
-//				collision_info_1 = Detect((Circle2D *) body1, (Box2D *) body2);
-//				collision_info_2 = Detect((Box2D *) body2, (Circle2D *) body1);
-			} else {
-				collision_info_1 = Detect((Box2D *) body1, (Box2D *) body2);
-				collision_info_2 = Detect((Box2D *) body2, (Box2D *) body1);
-			}
-
-			bool isInternal = collision_info_1.body1->GetCollisionType() == CollisionType::Internal;
-
-			if (collision_info_1.isCollided && (isInternal || collision_info_2.isCollided)) {
-				auto pd1 = collision_info_1.penetrationDepth;
-				auto pd2 = isInternal ? 1E6f : collision_info_2.penetrationDepth;
-
-				if (glm::min(pd1, pd2) < EPS) continue;
-
-				if (pd1 < pd2)
-					result.push_back(collision_info_1);
-				else
-					result.push_back(collision_info_2);
-			}
+			CollisionInfo info;
+			if (DetectPair(body1, body2, info))
+				result.push_back(info);
 		}
 	}
 
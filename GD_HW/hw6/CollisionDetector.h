@@ -13,6 +13,20 @@ struct CollisionInfo {
 	bool isCollided;
 };
 
+struct Ray2D {
+	glm::vec2 origin;
+	glm::vec2 direction; // must be normalized
+	float maxDistance;
+};
+
+struct RayHit {
+	Body2D *body;
+	glm::vec2 point;
+	glm::vec2 normal;
+	float distance;
+	bool isHit;
+};
+
 class CollisionDetector {
 public:
 	static bool ShapeContainsPoint(Body2D *body, glm::vec2 p);
@@ -23,6 +37,10 @@ public:
 
 	static bool IsPointBetweenTwoPoint(glm::vec2 v1, glm::vec2 v2, glm::vec2 p);
 
+	/// casts a ray (or a circle of `radius` swept along it) against a single body.
+	/// rays starting inside an external body are ignored, internal bodies are hit from inside.
+	static bool RayCast(Body2D *body, const Ray2D &ray, float radius, RayHit &hit);
+
 	CollisionInfo Detect(Body2D *body1, Body2D *body2) const;
 
 	CollisionInfo Detect(Body2D *body1, Circle2D *body2) const;
@@ -31,5 +49,12 @@ public:
 
 	CollisionInfo Detect(Circle2D *body1, Circle2D *body2) const;
 
+	/// narrow-phase for one pair, keeps the shallower of the two directions
+	bool DetectPair(Body2D *body1, Body2D *body2, CollisionInfo &info) const;
+
+	/// exact test of a body against a static boundary (an internal circle or box) it must stay inside of
+	bool DetectStatic(Body2D *boundary, Body2D *body, CollisionInfo &info) const;
+
+	/// brute force over all pairs, PhysicalEngine runs a broad-phase before DetectPair instead
 	std::vector<CollisionInfo> Detect(std::vector<Body2D *> *bodies) const;
 };
\ No newline at end of file
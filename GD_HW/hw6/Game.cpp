@@ -71,6 +71,8 @@ namespace PhysicalSimulationGame {
 			scene->ToggleResolverActivity();
 		} else if ((key == GLFW_KEY_LEFT_ALT || key == GLFW_KEY_RIGHT_ALT) && action == GLFW_PRESS) {
 			scene->ToggleDrawLite();
+		} else if (key == GLFW_KEY_S && action == GLFW_PRESS) {
+			scene->ToggleSensor();
 		}
 	}
 
@@ -1,28 +1,206 @@
+#include <algorithm>
 #include "PhysicalEngine.h"
 
 void PhysicalEngine::AddRigidBody(Body2D *body) {
 	this->RigidBodies->push_back(body);
+	isChangedQueryTree = true;
 }
 
 void PhysicalEngine::SetRigidBodies(std::vector<Body2D *> *rigidBodies) {
+	if (this->RigidBodies != rigidBodies) {
+		// bodies of another set never exit, so they get no events
+		isChangedQueryTree = true;
+		this->previousTriggers.clear();
+	}
 	this->RigidBodies = rigidBodies;
 }
 
 void PhysicalEngine::Update(float dt) {
+	this->triggerEvents.clear();
 	if (!isChangedRigidBodies && this->currentCollisionInfo.size() == 0) return;
 	isChangedRigidBodies = false;
 
+	this->currentCollisionInfo.clear();
+	this->currentTriggers.clear();
+
+	// Static geometry
+	DetectStatic();
+
+	// Broad-phase
+	FindPairs();
+
+	// Narrow-phase
+	for (auto [i, j] : this->pairs) {
+		auto body1 = (*this->RigidBodies)[i];
+		auto body2 = (*this->RigidBodies)[j];
+
+		CollisionInfo info;
+		if (!detector.DetectPair(body1, body2, info)) continue;
+
+		if (body1->IsSensor() || body2->IsSensor())
+			this->currentTriggers.push_back(std::minmax(body1, body2));
+		else
+			this->currentCollisionInfo.push_back(info);
+	}
+	std::sort(this->currentTriggers.begin(), this->currentTriggers.end());
+	UpdateTriggers();
+
 	// Dynamic
-	this->currentCollisionInfo = detector.Detect(this->RigidBodies);
-	if (this->resolveCollision)
+	if (this->resolveCollision && !this->currentCollisionInfo.empty()) {
 		resolver.Resolve(this->currentCollisionInfo);
+		isChangedQueryTree = true;
+	}
 	// Impulse
 }
 
+void PhysicalEngine::DetectStatic() {
+	RefreshQueryTree();
+
+	auto &bodies = *this->RigidBodies;
+	for (auto i : this->staticBodies) {
+		auto boundary = bodies[i];
+		for (auto j : this->dynamicBodies) {
+			auto body = bodies[j];
+			if (!boundary->ShouldCollide(body)) continue;
+
+			CollisionInfo info;
+			if (!detector.DetectStatic(boundary, body, info)) continue;
+
+			if (boundary->IsSensor() || body->IsSensor())
+				this->currentTriggers.push_back(std::minmax(boundary, body));
+			else
+				this->currentCollisionInfo.push_back(info);
+		}
+	}
+}
+
+void PhysicalEngine::FindPairs() {
+	RefreshQueryTree();
+	this->pairs.clear();
+
+	auto &bodies = *this->RigidBodies;
+	for (auto i : this->dynamicBodies) {
+		auto body1 = bodies[i];
+		queryTree.Query(body1->GetAABB(), [&](int j) {
+			auto body2 = bodies[j];
+			if (j <= i || !body1->ShouldCollide(body2)) return;
+			this->pairs.emplace_back(i, j);
+		});
+	}
+
+	// same order as the brute force loop, so resolution order doesn't change
+	std::sort(this->pairs.begin(), this->pairs.end());
+}
+
+void PhysicalEngine::UpdateTriggers() {
+	auto event = [&](std::pair<Body2D *, Body2D *> pair, TriggerEventType type) {
+		auto [body1, body2] = pair;
+		if (body1->IsSensor()) this->triggerEvents.push_back(TriggerEvent{body1, body2, type});
+		else this->triggerEvents.push_back(TriggerEvent{body2, body1, type});
+	};
+
+	// both lists are sorted, walk them together
+	auto current = this->currentTriggers.begin();
+	auto previous = this->previousTriggers.begin();
+	while (current != this->currentTriggers.end() || previous != this->previousTriggers.end()) {
+		if (previous == this->previousTriggers.end() || (current != this->currentTriggers.end() && *current < *previous)) {
+			event(*current++, TriggerEventType::Enter);
+		} else if (current == this->currentTriggers.end() || *previous < *current) {
+			event(*previous++, TriggerEventType::Exit);
+		} else {
+			current++;
+			previous++;
+		}
+	}
+
+	std::swap(this->currentTriggers, this->previousTriggers);
+}
+
 std::vector<CollisionInfo> PhysicalEngine::CurrentCollisionInfo() {
 	return this->currentCollisionInfo;
 }
 
+std::vector<TriggerEvent> PhysicalEngine::CurrentTriggerEvents() {
+	return this->triggerEvents;
+}
+
 void PhysicalEngine::SetResolverAcivity(bool resolveCollision) {
 	this->resolveCollision = resolveCollision;
 }
+
+void PhysicalEngine::RefreshQueryTree() {
+	if (!isChangedQueryTree || this->RigidBodies == nullptr) return;
+	isChangedQueryTree = false;
+
+	auto &bodies = *this->RigidBodies;
+	this->staticBodies.clear();
+	this->dynamicBodies.clear();
+	for (int i = 0; i < (int) bodies.size(); i++) {
+		if (bodies[i]->GetCollisionType() == CollisionType::Internal) this->staticBodies.push_back(i);
+		else this->dynamicBodies.push_back(i);
+	}
+
+	queryTree.Build(bodies, this->dynamicBodies);
+}
+
+int PhysicalEngine::RayCast(const Ray2D *rays, RayHit *hits, int count) {
+	return CircleCast(rays, 0, hits, count);
+}
+
+int PhysicalEngine::CircleCast(const Ray2D *rays, float radius, RayHit *hits, int count) {
+	RefreshQueryTree();
+
+	int hitCount = 0;
+	for (int i = 0; i < count; i++) {
+		auto &ray = rays[i];
+		auto &hit = hits[i];
+		hit = RayHit{nullptr, glm::vec2(0), glm::vec2(0), ray.maxDistance, false};
+
+		auto visit = [&](int index, float &maxDistance) {
+			RayHit candidate;
+			auto clipped = Ray2D{ray.origin, ray.direction, maxDistance};
+			if (CollisionDetector::RayCast((*this->RigidBodies)[index], clipped, radius, candidate)) {
+				hit = candidate;
+				maxDistance = candidate.distance;
+			}
+		};
+
+		float maxDistance = ray.maxDistance;
+		for (auto index : this->staticBodies) visit(index, maxDistance);
+		queryTree.Query(Ray2D{ray.origin, ray.direction, maxDistance}, radius, visit);
+
+		if (hit.isHit) hitCount++;
+	}
+	return hitCount;
+}
+
+int PhysicalEngine::QueryAABB(const AABB &box, Body2D **result, int capacity) {
+	RefreshQueryTree();
+
+	int found = 0;
+	auto visit = [&](int index) {
+		if (found < capacity) result[found] = (*this->RigidBodies)[index];
+		found++;
+	};
+
+	for (auto index : this->staticBodies)
+		if ((*this->RigidBodies)[index]->GetAABB().Overlaps(box)) visit(index);
+	queryTree.Query(box, visit);
+	return found;
+}
+
+int PhysicalEngine::QueryPoint(glm::vec2 point, Body2D **result, int capacity) {
+	RefreshQueryTree();
+
+	int found = 0;
+	auto visit = [&](int index) {
+		auto body = (*this->RigidBodies)[index];
+		if (!CollisionDetector::ShapeContainsPoint(body, point)) return;
+		if (found < capacity) result[found] = body;
+		found++;
+	};
+
+	for (auto index : this->staticBodies) visit(index);
+	queryTree.Query(AABB{point, point}, visit);
+	return found;
+}
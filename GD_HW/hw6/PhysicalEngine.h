@@ -2,6 +2,17 @@
 
 #include "CollisionDetector.h"
 #include "CollisionResolver.h"
+#include "BodyTree.h"
+
+enum class TriggerEventType {
+	Enter, Exit
+};
+
+struct TriggerEvent {
+	Body2D *sensor;
+	Body2D *other;
+	TriggerEventType type;
+};
 
 class PhysicalEngine {
 public:
@@ -9,7 +20,8 @@ public:
 	PhysicalEngine(bool resolveCollision) :
 			resolveCollision(resolveCollision),
 			RigidBodies(nullptr),
-			isChangedRigidBodies(false) {}
+			isChangedRigidBodies(false),
+			isChangedQueryTree(true) {}
 
 	void AddRigidBody(Body2D *body);
 
@@ -17,17 +29,54 @@ public:
 
 	std::vector<CollisionInfo> CurrentCollisionInfo();
 
+	/// sensor overlaps that started or ended in the last Update
+	std::vector<TriggerEvent> CurrentTriggerEvents();
+
 	void SetResolverAcivity(bool resolveCollision);
 
-	inline void SetChangedRigidBodies(bool changed) { isChangedRigidBodies = changed; }
+	inline void SetChangedRigidBodies(bool changed) {
+		isChangedRigidBodies = changed;
+		isChangedQueryTree |= changed;
+	}
 
 	void Update(float dt);
 
+	// Queries, all of them write into caller owned arrays and never allocate
+
+	/// writes the closest hit of each ray into `hits`, returns the number of rays that hit
+	int RayCast(const Ray2D *rays, RayHit *hits, int count);
+
+	/// like RayCast but sweeps a circle of `radius` along each ray
+	int CircleCast(const Ray2D *rays, float radius, RayHit *hits, int count);
+
+	/// collects bodies whose bounds overlap `box`, returns the total found (which may exceed `capacity`)
+	int QueryAABB(const AABB &box, Body2D **result, int capacity);
+
+	/// collects bodies containing `point`, returns the total found (which may exceed `capacity`)
+	int QueryPoint(glm::vec2 point, Body2D **result, int capacity);
+
 private:
+	void RefreshQueryTree();
+
+	void DetectStatic();
+
+	void FindPairs();
+
+	void UpdateTriggers();
+
 	CollisionDetector detector;
 	CollisionResolver resolver;
 	std::vector<Body2D *> *RigidBodies;
 	std::vector<CollisionInfo> currentCollisionInfo;
+	BodyTree queryTree;
+	std::vector<int> staticBodies;  // world boundaries, never part of the tree
+	std::vector<int> dynamicBodies;
+	std::vector<std::pair<int, int>> pairs;
+	// sensor pairs by body, in pointer order, so they match up when bodies are added between updates
+	std::vector<std::pair<Body2D *, Body2D *>> currentTriggers;
+	std::vector<std::pair<Body2D *, Body2D *>> previousTriggers;
+	std::vector<TriggerEvent> triggerEvents;
 	bool resolveCollision;
 	bool isChangedRigidBodies;
+	bool isChangedQueryTree;
 };
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "PhysicalEngine.h"
+
+// Headless benchmark for PhysicalEngine world queries
+// output: name;bodies;queries;hits;ms
+
+namespace QueryBench {
+	const int BODY_COUNT = 10000;
+	const int RAY_COUNT = 10000;
+	const float WORLD_SIZE = 2000;
+	const float RAY_LENGTH = 500;
+
+	std::vector<Body2D *> CreateBodies(std::mt19937 &random) {
+		std::uniform_real_distribution<float> position(-WORLD_SIZE / 2, WORLD_SIZE / 2);
+		std::uniform_real_distribution<float> size(2, 10);
+		std::uniform_real_distribution<float> angle(0, glm::pi<float>());
+
+		std::vector<Body2D *> bodies;
+		for (int i = 0; i < BODY_COUNT; i++) {
+			Body2D *body;
+			if (i % 2 == 0) body = new Box2D(size(random), size(random), 1);
+			else body = new Circle2D(size(random) / 2, 1);
+			body->MoveTo(position(random), position(random));
+			body->Rotate(angle(random));
+			bodies.push_back(body);
+		}
+		return bodies;
+	}
+
+	std::vector<Ray2D> CreateRays(std::mt19937 &random) {
+		std::uniform_real_distribution<float> position(-WORLD_SIZE / 2, WORLD_SIZE / 2);
+		std::uniform_real_distribution<float> angle(0, 2 * glm::pi<float>());
+
+		std::vector<Ray2D> rays;
+		for (int i = 0; i < RAY_COUNT; i++) {
+			auto a = angle(random);
+			rays.push_back(Ray2D{glm::vec2(position(random), position(random)), glm::vec2(glm::cos(a), glm::sin(a)),
+													 RAY_LENGTH});
+		}
+		return rays;
+	}
+
+	int BruteForceRayCast(const std::vector<Body2D *> &bodies, const Ray2D *rays, RayHit *hits, int count) {
+		int hitCount = 0;
+		for (int i = 0; i < count; i++) {
+			auto ray = rays[i];
+			hits[i] = RayHit{nullptr, glm::vec2(0), glm::vec2(0), ray.maxDistance, false};
+			for (auto body : bodies) {
+				RayHit hit;
+				if (CollisionDetector::RayCast(body, ray, 0, hit)) {
+					hits[i] = hit;
+					ray.maxDistance = hit.distance;
+				}
+			}
+			if (hits[i].isHit) hitCount++;
+		}
+		return hitCount;
+	}
+
+	template<class Fn>
+	void Measure(const char *name, int queries, Fn fn) {
+		auto start = std::chrono::high_resolution_clock::now();
+		int hits = fn();
+		auto stop = std::chrono::high_resolution_clock::now();
+		auto ms = std::chrono::duration<double, std::milli>(stop - start).count();
+		std::cout << name << ";" << BODY_COUNT << ";" << queries << ";" << hits << ";" << ms << std::endl;
+	}
+}
+
+using namespace QueryBench;
+
+int main() {
+	std::mt19937 random(1399);
+	auto bodies = CreateBodies(random);
+	auto rays = CreateRays(random);
+	std::vector<RayHit> hits(RAY_COUNT);
+
+	PhysicalEngine engine(false);
+	engine.SetRigidBodies(&bodies);
+
+	std::cout << "name;bodies;queries;hits;ms" << std::endl;
+
+	Measure("brute-force-raycast", RAY_COUNT, [&]() {
+		return BruteForceRayCast(bodies, rays.data(), hits.data(), RAY_COUNT);
+	});
+
+	Measure("tree-build", 1, [&]() {
+		engine.SetChangedRigidBodies(true);
+		Body2D *result[1];
+		return engine.QueryPoint(glm::vec2(0), result, 1);
+	});
+
+	Measure("raycast", RAY_COUNT, [&]() {
+		return engine.RayCast(rays.data(), hits.data(), RAY_COUNT);
+	});
+
+	Measure("circlecast", RAY_COUNT, [&]() {
+		return engine.CircleCast(rays.data(), 2, hits.data(), RAY_COUNT);
+	});
+
+	Measure("aabb-query", RAY_COUNT, [&]() {
+		Body2D *result[64];
+		int found = 0;
+		for (auto &ray : rays)
+			found += engine.QueryAABB(AABB{ray.origin - glm::vec2(20), ray.origin + glm::vec2(20)}, result, 64);
+		return found;
+	});
+
+	for (auto body : bodies) delete body;
+	return 0;
+}
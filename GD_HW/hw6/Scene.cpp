@@ -2,6 +2,8 @@
 
 #include <GL/glew.h>
 
+#include <algorithm>
+
 #include "Scene.h"
 #include "CollisionDetector.h"
 
@@ -40,6 +42,8 @@ void Scene::render() {
 
 		if (isInternal || this->selectedRigidBody == i)
 			glColor3f(0, 0, 1);
+		else if (body->IsSensor())
+			glColor3f(1, 1, 0);
 		else
 			glColor3f(0, 1, 0);
 
@@ -83,16 +87,25 @@ int Scene::AddCircle(float r, float mass, CollisionType type) {
 }
 
 void Scene::Select(int x, int y) {
-	auto p = glm::vec2(x, y);
-	for (int i = 0; i < this->rigidBodies.size(); i++) {
-		auto body = this->rigidBodies[i];
-		if (body->GetCollisionType() == CollisionType::Internal) continue;
+	static const int MAX_PICKS = 16;
+	std::vector<Body2D *> picks(MAX_PICKS);
+
+	physicalEngine.SetRigidBodies(&this->rigidBodies);
+	auto found = physicalEngine.QueryPoint(glm::vec2(x, y), picks.data(), MAX_PICKS);
+	if (found > MAX_PICKS) {
+		picks.resize(found);
+		found = physicalEngine.QueryPoint(glm::vec2(x, y), picks.data(), found);
+	}
 
-		if (CollisionDetector::ShapeContainsPoint(body, p)) {
-			selectedRigidBody = i;
-			return;
-		}
+	// the tree gives hits in any order, the lowest index wins like the old front to back scan
+	int selected = -1;
+	for (int i = 0; i < found; i++) {
+		if (picks[i]->GetCollisionType() == CollisionType::Internal) continue;
+
+		auto index = int(std::find(this->rigidBodies.begin(), this->rigidBodies.end(), picks[i]) - this->rigidBodies.begin());
+		if (selected < 0 || index < selected) selected = index;
 	}
+	if (selected >= 0) selectedRigidBody = selected;
 }
 
 void Scene::Select(int index) {
@@ -134,6 +147,14 @@ void Scene::ToggleDrawLite() {
 	drawLite = !drawLite;
 }
 
+void Scene::ToggleSensor() {
+	if (selectedRigidBody >= 0) {
+		auto body = this->rigidBodies[selectedRigidBody];
+		body->SetSensor(!body->IsSensor());
+		physicalEngine.SetChangedRigidBodies(true);
+	}
+}
+
 std::vector<Body2D *> Scene::GetRigidBodies() {
 	return this->rigidBodies;
 }
@@ -35,6 +35,8 @@ public:
 
 	void ToggleDrawLite();
 
+	void ToggleSensor();
+
 private:
 	PhysicalEngine physicalEngine;
 	std::vector<Body2D *> rigidBodies;
@@ -0,0 +1,248 @@
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "Scene.hpp"
+#include "SceneGenerator.hpp"
+
+// Headless benchmark for the SimpleVision visibility update, no window or GL needed
+// usage: simple-vision-bench [uniform|clustered|corridor objects queries] to only sweep one field
+// output: stage;layout;objects;queries;us_per_query;queries_per_second;tested_per_query,
+// events per query instead of tested for the events stages
+// then: stage;objects;observers;threads;ticks;ms_per_tick;tested_per_observer;events_per_tick
+
+namespace SimpleVisionBench {
+	const float VISION_RANGE = 25;
+	const float VISION_FOV = 90;
+	const uint32_t SEED = 1399;
+
+	// what Scene::update used to do, every vertex of every object against the range with a sqrt each
+	int BruteForceUpdate(const std::vector<Object *> &objects, glm::vec2 vision_pos, float vision_range) {
+		int visible = 0;
+		for (auto object : objects) {
+			object->visible = false;
+			for (auto v : object->GetVertices()) {
+				if (glm::length(v - vision_pos) < vision_range) {
+					object->visible = true;
+					visible++;
+					break;
+				}
+			}
+		}
+		return visible;
+	}
+
+	// what Object::GenerateVertices used to do on every move, a mat4 rotate and a cos and sin per vertex
+	void LegacySegmentVertices(std::vector<glm::vec2> &vertices, int segs, float radius, float angle, glm::vec2 pos) {
+		const auto rm = glm::rotate(glm::mat4(1), glm::radians(angle), glm::vec3(0, 0, 1));
+
+		vertices.clear();
+		vertices.emplace_back(pos.x, pos.y);
+		for (int ii = 0; ii < segs + 1; ii++) {
+			float theta = 2.0f * glm::pi<float>() * float(ii) / float(segs);
+			auto v = glm::vec2(rm * glm::vec4(radius * glm::cos(theta), radius * glm::sin(theta), 0, 1)) + pos;
+			vertices.push_back(v);
+		}
+	}
+
+	// an AI that only hears about changes
+	struct EventCounter {
+		long events = 0;
+
+		void OnEvents(const VisibilityEvent *, int count) { events += count; }
+	};
+
+	template<class Fn>
+	void Measure(const char *stage, FieldLayout layout, int objects, int queries, Fn fn) {
+		long tested = 0;
+		auto start = std::chrono::high_resolution_clock::now();
+		for (int query = 0; query < queries; query++) tested += fn(query);
+		auto stop = std::chrono::high_resolution_clock::now();
+		auto us = std::chrono::duration<double, std::micro>(stop - start).count() / queries;
+		std::cout << stage << ";" << FIELD_LAYOUT_NAMES[layout] << ";" << objects << ";" << queries << ";"
+		          << us << ";" << 1000000 / us << ";" << double(tested) / queries << std::endl;
+	}
+
+	// the vision walks the path of the field once over all queries
+	void VisibilityBench(FieldLayout layout, int count, int queries) {
+		Scene scene;
+		GenerateField(scene, layout, count, SEED);
+		auto objects = scene.GetObjects();
+		auto path = [&](int query) { return FieldPath(layout, count, float(query) / float(queries)); };
+
+		long visibleBrute = 0, visibleIndexed = 0;
+		Measure("brute-force", layout, count, queries, [&](int query) {
+			visibleBrute += BruteForceUpdate(objects, path(query), VISION_RANGE);
+			return count;
+		});
+
+		scene.SetOcclusion(false);
+		scene.update(0); // builds the grid
+		Measure("grid", layout, count, queries, [&](int query) {
+			auto pos = path(query);
+			scene.SetVisionPos(pos.x, pos.y);
+			scene.update(0);
+			visibleIndexed += long(scene.GetVisibleObjects().size());
+			return scene.GetTestedCount();
+		});
+
+		if (visibleBrute != visibleIndexed)
+			std::cout << "mismatch;" << FIELD_LAYOUT_NAMES[layout] << ";" << count << ";" << visibleBrute << ";" << visibleIndexed << std::endl;
+
+		EventCounter counter;
+		scene.AddObserver(&counter);
+		Measure("grid-events", layout, count, queries, [&](int query) {
+			auto pos = path(query);
+			auto before = counter.events;
+			scene.SetVisionPos(pos.x, pos.y);
+			scene.update(0);
+			return int(counter.events - before);
+		});
+		scene.RemoveObserver(&counter);
+
+		// looking along the path, objects hide what is behind them
+		scene.SetOcclusion(true);
+		for (float fov : {VISION_FOV, 360.0f}) {
+			Measure(fov < 360 ? "cone-sweep" : "cone-sweep-360", layout, count, queries, [&](int query) {
+				auto pos = path(query);
+				auto ahead = path(query + 1) - pos;
+				scene.SetVisionPos(pos.x, pos.y);
+				scene.SetVisionCone(glm::degrees(std::atan2(ahead.y, ahead.x)), fov);
+				scene.update(0);
+				return scene.GetTestedCount();
+			});
+		}
+	}
+
+	// every object moves every frame, then one range query sees the field
+	void MoveBench() {
+		const int count = 100000;
+		const int frames = 20;
+		Scene scene;
+		GenerateField(scene, FIELD_UNIFORM, count, SEED);
+		scene.SetOcclusion(false);
+		auto objects = scene.GetObjects();
+		std::vector<std::vector<glm::vec2>> legacy(count);
+
+		Measure("move-regenerate", FIELD_UNIFORM, count, frames, [&](int frame) {
+			for (int i = 0; i < count; i++) {
+				auto object = objects[i];
+				auto position = object->GetPosition() + glm::vec2(frame % 2 == 0 ? 0.1f : -0.1f, 0);
+				LegacySegmentVertices(legacy[i], object->GetSegments(), object->GetRadius(), object->GetAngle(), position);
+				object->SetPosition(position);
+			}
+			return count;
+		});
+
+		Measure("move-transform", FIELD_UNIFORM, count, frames, [&](int frame) {
+			for (auto object : objects)
+				object->SetPosition(object->GetPosition() + glm::vec2(frame % 2 == 0 ? 0.1f : -0.1f, 0));
+			return count;
+		});
+
+		Measure("move-transform-update", FIELD_UNIFORM, count, frames, [&](int frame) {
+			for (int i = 0; i < count; i++) {
+				auto position = objects[i]->GetPosition() + glm::vec2(frame % 2 == 0 ? 0.1f : -0.1f, 0);
+				scene.MoveObject(i, position.x, position.y);
+			}
+			scene.update(0);
+			return scene.GetTestedCount();
+		});
+	}
+
+	// what the renderer does on the CPU for a frame of 100k objects, the GL side needs a window
+	void RenderBench() {
+		const int count = 100000;
+		const int frames = 20;
+		Scene scene;
+		GenerateField(scene, FIELD_UNIFORM, count, SEED);
+		scene.update(0);
+		auto objects = scene.GetObjects();
+
+		// the old loop copied every vertex vector before its own glBegin and glEnd
+		long sink = 0;
+		Measure("render-copy", FIELD_UNIFORM, count, frames, [&](int) {
+			for (auto object : objects) {
+				auto vertices = object->GetVertices();
+				sink += long(vertices.size());
+			}
+			return count;
+		});
+
+		OutlineBatch batch;
+		Measure("render-batch-fill", FIELD_UNIFORM, count, frames, [&](int) {
+			batch.Fill(objects);
+			return count;
+		});
+		if (sink == 0) std::cout << "empty" << std::endl;
+	}
+
+	// agents wander through the field and turn a little every tick, all seen in one batch
+	void ObserverBench() {
+		const int count = 100000;
+		const int ticks = 50;
+		std::mt19937 random(SEED);
+		Scene scene;
+		GenerateField(scene, FIELD_UNIFORM, count, SEED);
+		scene.SetOcclusion(false);
+		const float half = FieldSize(count) / 2;
+
+		for (int observerCount : {100, 1000}) {
+			std::uniform_real_distribution<float> position(-half, half);
+			std::uniform_real_distribution<float> heading(0, 360);
+			std::uniform_real_distribution<float> step(-1, 1);
+			scene.RemoveAgents();
+			for (int i = 0; i < observerCount; i++)
+				scene.AddAgent(ViewCone{glm::vec2(position(random), position(random)), heading(random), VISION_RANGE, VISION_FOV});
+			scene.update(0);
+
+			long events = 0;
+			auto start = std::chrono::high_resolution_clock::now();
+			for (int tick = 0; tick < ticks; tick++) {
+				for (int i = 0; i < observerCount; i++) {
+					auto cone = scene.GetAgents()[i];
+					cone.position += glm::vec2(step(random), step(random));
+					cone.heading += 5 * step(random);
+					scene.SetAgent(i, cone);
+				}
+				scene.update(0);
+				events += long(scene.GetObserverBatch().GetEvents().size());
+			}
+			auto stop = std::chrono::high_resolution_clock::now();
+			auto ms = std::chrono::duration<double, std::milli>(stop - start).count() / ticks;
+			std::cout << "observers;" << count << ";" << observerCount << ";" << std::thread::hardware_concurrency() << ";"
+			          << ticks << ";" << ms << ";" << double(scene.GetObserverBatch().GetTestedCount()) / observerCount << ";"
+			          << double(events) / ticks << std::endl;
+		}
+	}
+}
+
+using namespace SimpleVisionBench;
+
+int main(int argc, char **argv) {
+	std::cout << "stage;layout;objects;queries;us_per_query;queries_per_second;tested_per_query" << std::endl;
+	if (argc == 4) {
+		if (std::stoi(argv[2]) <= 0 || std::stoi(argv[3]) <= 0) {
+			std::cerr << "objects and queries must be positive" << std::endl;
+			return 1;
+		}
+		for (int layout = FIELD_UNIFORM; layout <= FIELD_CORRIDOR; layout++)
+			if (std::strcmp(argv[1], FIELD_LAYOUT_NAMES[layout]) == 0)
+				VisibilityBench(FieldLayout(layout), std::stoi(argv[2]), std::stoi(argv[3]));
+		return 0;
+	}
+
+	for (auto layout : {FIELD_UNIFORM, FIELD_CLUSTERED, FIELD_CORRIDOR})
+		for (int count : {1000, 10000, 100000})
+			VisibilityBench(layout, count, std::max(20, 10000000 / count));
+	MoveBench();
+	RenderBench();
+	std::cout << "stage;objects;observers;threads;ticks;ms_per_tick;tested_per_observer;events_per_tick" << std::endl;
+	ObserverBench();
+	return 0;
+}
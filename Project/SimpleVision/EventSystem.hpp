@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+
+/// the subject and observer of GD_HW/hw2v3/EventSystem.hpp without virtual calls and one event at a time.
+/// events are queued while a tick runs and every observer gets them all in one call at the flush.
+/// an observer is any class with OnEvents(const Event *events, int count), bound when it is added.
+template<class Event>
+class EventSubject {
+public:
+	/// register a new observer to receive event batches
+	template<class Observer>
+	bool AddObserver(Observer *observer) {
+		observers.push_back(Entry{observer, [](void *target, const Event *events, int count) {
+			((Observer *) target)->OnEvents(events, count);
+		}});
+		return true;
+	}
+
+	/// unregister an observer
+	bool RemoveObserver(const void *observer) {
+		for (auto it = observers.begin(); it != observers.end(); it++) {
+			if (it->observer == observer) {
+				observers.erase(it);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/// unregister all observers
+	bool ClearObservers() {
+		observers.clear();
+		return true;
+	}
+
+	[[nodiscard]]
+	bool HasObservers() const { return !observers.empty(); }
+
+protected:
+	/// held back till the next flush
+	void QueueEvent(const Event &event) { pending.push_back(event); }
+
+	/// notify all observers of the queued events, nothing is called when there are none
+	bool FlushEvents() {
+		if (pending.empty()) return false;
+		for (auto &entry : observers) entry.callback(entry.observer, pending.data(), int(pending.size()));
+		pending.clear();
+		return true;
+	}
+
+	std::vector<Event> pending;
+
+private:
+	struct Entry {
+		void *observer;
+		void (*callback)(void *, const Event *, int);
+	};
+
+	std::vector<Entry> observers;
+};
@@ -7,7 +7,7 @@
 #include <thread>
 #include <random>
 
-#include "Scene.hpp"
+#include "SceneRender.hpp"
 
 namespace SimpleVisionGame {
 	Scene *scene;
@@ -55,6 +55,12 @@ namespace SimpleVisionGame {
 			changeRotation = 1;
 		} else if (key == GLFW_KEY_C && action == GLFW_PRESS) {
 			create_shape = true;
+		} else if (key == GLFW_KEY_V && action == GLFW_PRESS) {
+			scene->SetOcclusion(!scene->GetOcclusion());
+		} else if (key == GLFW_KEY_A && action != GLFW_RELEASE) {
+			scene->RotateVision(5);
+		} else if (key == GLFW_KEY_D && action != GLFW_RELEASE) {
+			scene->RotateVision(-5);
 		}
 	}
 
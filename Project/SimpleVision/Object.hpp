@@ -1,39 +1,110 @@
+#pragma once
+
+#include <unordered_map>
 #include <vector>
-#include <glm/vec2.hpp>
-
-void SegmentVertices(std::vector<glm::vec2> &vertices, int segs, float radius, float angle, glm::vec2 pos) {
-	const auto rm = glm::rotate(glm::mat4(1), glm::radians(angle), glm::vec3(0, 0, 1));
-
-	vertices.clear();
-	vertices.emplace_back(pos.x, pos.y);
-	for (int ii = 0; ii < segs + 1; ii++) {
-		float theta = 2.0f * glm::pi<float>() * float(ii) / float(segs);//get the current angle
-		float x = radius * glm::cos(theta); //calculate the x component
-		float y = radius * glm::sin(theta); //calculate the y component
-		auto v = glm::vec2(rm * glm::vec4(x, y, 0, 1)) + pos;
-		vertices.push_back(v); //output vertex
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+
+/// polygon of a segment count around the unit circle, the center first then the closed ring.
+/// made once per count and shared, an object only keeps a pointer to its shape.
+/// shapes are made on the calling thread, so objects are created outside of parallel loops
+const std::vector<glm::vec2> &UnitShape(int segments) {
+	static std::unordered_map<int, std::vector<glm::vec2>> shapes; // nodes keep their place on rehash
+
+	auto &shape = shapes[segments];
+	if (shape.empty()) {
+		shape.emplace_back(0, 0);
+		for (int ii = 0; ii < segments + 1; ii++) {
+			float theta = 2.0f * glm::pi<float>() * float(ii) / float(segments);
+			shape.emplace_back(glm::cos(theta), glm::sin(theta));
+		}
 	}
+	return shape;
 }
 
-std::vector<glm::vec2> CircleVertices(float radius, float angle, glm::vec2 pos) {
-	const auto segs = 10 + int(radius / 5);
-	std::vector<glm::vec2> vertices;
-	SegmentVertices(vertices, segs, radius, angle, pos);
-	return vertices;
-}
+/// a unit shape placed by a transform, writing the transform is all a move or rotate costs.
+/// world vertices are only made when asked for after a change
+class Object {
+public:
+	Object(int segments, float radius, float angle, glm::vec2 position)
+			: segments(segments), radius(radius), position(position), shape(&UnitShape(segments)) {
+		SetAngle(angle);
+	}
+
+	[[nodiscard]]
+	int GetSegments() const { return segments; }
+
+	[[nodiscard]]
+	float GetRadius() const { return radius; }
+
+	[[nodiscard]]
+	float GetAngle() const { return angle; }
+
+	[[nodiscard]]
+	glm::vec2 GetPosition() const { return position; }
+
+	void SetAngle(float value) {
+		angle = value;
+		axis = glm::vec2(glm::cos(glm::radians(angle)), glm::sin(glm::radians(angle))) * radius;
+		vertices_dirty = true;
+	}
+
+	void SetPosition(glm::vec2 value) {
+		position = value;
+		vertices_dirty = true;
+	}
+
+	[[nodiscard]]
+	const std::vector<glm::vec2> &GetShape() const { return *shape; }
+
+	/// a point of the unit shape in world space
+	[[nodiscard]]
+	glm::vec2 ToWorld(glm::vec2 unit) const {
+		return position + glm::vec2(axis.x * unit.x - axis.y * unit.y, axis.y * unit.x + axis.x * unit.y);
+	}
+
+	/// the shape in world space, made again only if the transform changed since the last call.
+	/// not for parallel loops, they read GetShape through ToWorld instead
+	const std::vector<glm::vec2> &GetVertices() const;
 
-struct Object {
-	int segments = 5;
-	float radius = 5;
-	float angle = 0;
-	glm::vec2 position;
 	bool visible = false;
 
-	std::vector<glm::vec2> vertices;
+private:
+	int segments;
+	float radius;
+	float angle = 0;
+	glm::vec2 position;
+	glm::vec2 axis; // rotation scaled by radius, the unit x axis in world space
 
-	void GenerateVertices();
+	const std::vector<glm::vec2> *shape;
+	mutable std::vector<glm::vec2> vertices;
+	mutable bool vertices_dirty = true;
 };
 
-void Object::GenerateVertices() {
-	::SegmentVertices(vertices, segments, radius, angle, position);
+const std::vector<glm::vec2> &Object::GetVertices() const {
+	if (vertices_dirty) {
+		vertices.resize(shape->size());
+		for (size_t i = 0; i < shape->size(); i++) vertices[i] = ToWorld((*shape)[i]);
+		vertices_dirty = false;
+	}
+	return vertices;
+}
+
+/// true if any vertex of object is closer than range to pos.
+/// every vertex lies within radius of position, so the bounding circle rejects or accepts most objects
+/// and only those crossing the range border test their vertices, all with squared distances.
+/// the vertices come straight from the shape, so no world vertices are made for this
+bool InRange(const Object &object, glm::vec2 pos, float range) {
+	const auto d = object.GetPosition() - pos;
+	const auto dist2 = glm::dot(d, d);
+	const auto outer = range + object.GetRadius();
+	if (dist2 >= outer * outer) return false;
+	if (dist2 < range * range) return true; // the center is vertex 0
+
+	const auto range2 = range * range;
+	for (auto &unit : object.GetShape()) {
+		const auto dv = object.ToWorld(unit) - pos;
+		if (glm::dot(dv, dv) < range2) return true;
+	}
+	return false;
 }
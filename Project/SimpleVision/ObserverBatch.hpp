@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Object.hpp"
+#include "SpatialGrid.hpp"
+#include "ThreadPool.hpp"
+#include "Visibility.hpp"
+
+/// an object coming into or going out of the view of one observer
+struct VisibilityEvent {
+	int observer;
+	int object;
+	bool visible; // true when it came into view
+};
+
+/// calls fn(object, visible) for what is only in now (true) or only in before (false), both sorted
+template<class Fn>
+void DiffVisible(const std::vector<int> &before, const std::vector<int> &now, Fn fn) {
+	size_t i = 0, j = 0;
+	while (i < now.size() || j < before.size()) {
+		if (j == before.size() || (i < now.size() && now[i] < before[j]))
+			fn(now[i++], true);
+		else if (i == now.size() || before[j] < now[i])
+			fn(before[j++], false);
+		else {
+			i++;
+			j++;
+		}
+	}
+}
+
+/// visibility of many observers at once, like AI agents asking what they see every tick.
+/// observers are split over the pool and all query the same grid, each thread sweeps with its own buffers.
+/// every observer keeps its sorted visible objects and a bitset of them, the new list is merged against
+/// the old one so only the changes become events, in observer then object order.
+class ObserverBatch {
+public:
+	/// observers handed to one thread at a time
+	static const int OBSERVER_GRAIN = 8;
+
+	explicit ObserverBatch(ThreadPool *pool) : pool(pool) {}
+
+	/// sees for every observer, observer i keeps its state from the last call.
+	/// objects must be the ones grid was built from
+	void Update(const std::vector<ViewCone> &observers, const std::vector<Object *> &objects, const SpatialGrid &grid);
+
+	/// changes of the last Update
+	[[nodiscard]]
+	const std::vector<VisibilityEvent> &GetEvents() const { return events; }
+
+	[[nodiscard]]
+	const std::vector<int> &GetVisibleObjects(int observer) const { return states[observer].visible; }
+
+	/// one bit per object, GetWordCount words for each observer
+	[[nodiscard]]
+	const uint64_t *GetVisibleBits(int observer) const { return bits.data() + size_t(observer) * word_count; }
+
+	[[nodiscard]]
+	int GetWordCount() const { return word_count; }
+
+	[[nodiscard]]
+	bool IsVisible(int observer, int object) const {
+		return object < object_count && (GetVisibleBits(observer)[object / 64] >> (object % 64) & 1) != 0;
+	}
+
+	/// objects the grid handed over in the last Update, over all observers
+	[[nodiscard]]
+	long GetTestedCount() const { return tested_count; }
+
+private:
+	struct ObserverState {
+		std::vector<int> visible;
+		std::vector<int> previous;
+		std::vector<VisibilityEvent> events;
+		int tested = 0;
+	};
+
+	void See(int observer, const ViewCone &cone, const std::vector<Object *> &objects, const SpatialGrid &grid);
+
+	ThreadPool *pool;
+	std::vector<ObserverState> states;
+	std::vector<uint64_t> bits;
+	std::vector<VisibilityEvent> events;
+	int object_count = 0;
+	int word_count = 0;
+	long tested_count = 0;
+};
+
+void ObserverBatch::Update(const std::vector<ViewCone> &observers, const std::vector<Object *> &objects,
+                           const SpatialGrid &grid) {
+	const auto n = int(observers.size());
+
+	// observers that went away leave everything they saw
+	events.clear();
+	for (int o = n; o < int(states.size()); o++)
+		for (auto object : states[o].visible) events.push_back(VisibilityEvent{o, object, false});
+	states.resize(n);
+
+	// objects are only ever added, a wider bitset is rebuilt from the visible lists
+	const auto words = (int(objects.size()) + 63) / 64;
+	object_count = int(objects.size());
+	if (words != word_count || bits.size() != size_t(n) * words) {
+		word_count = words;
+		bits.assign(size_t(n) * words, 0);
+		for (int o = 0; o < n; o++)
+			for (auto object : states[o].visible) bits[size_t(o) * words + object / 64] |= uint64_t(1) << (object % 64);
+	}
+
+	pool->ParallelFor(n, OBSERVER_GRAIN, [&](int begin, int end) {
+		for (int o = begin; o < end; o++) See(o, observers[o], objects, grid);
+	});
+
+	tested_count = 0;
+	for (auto &state : states) {
+		events.insert(events.end(), state.events.begin(), state.events.end());
+		tested_count += state.tested;
+	}
+}
+
+void ObserverBatch::See(int observer, const ViewCone &cone, const std::vector<Object *> &objects,
+                        const SpatialGrid &grid) {
+	static thread_local VisibilitySweep sweep;
+
+	auto &state = states[observer];
+	std::swap(state.visible, state.previous);
+	sweep.Compute(cone, objects, grid, state.visible);
+	state.tested = sweep.GetCandidateCount();
+
+	auto word = bits.data() + size_t(observer) * word_count;
+	state.events.clear();
+	DiffVisible(state.previous, state.visible, [&](int object, bool visible) {
+		if (visible)
+			word[object / 64] |= uint64_t(1) << (object % 64);
+		else
+			word[object / 64] &= ~(uint64_t(1) << (object % 64));
+		state.events.push_back(VisibilityEvent{observer, object, visible});
+	});
+}
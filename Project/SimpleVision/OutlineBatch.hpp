@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Object.hpp"
+
+/// every object outline as line pairs in one vertex array, made straight from the shapes.
+/// hidden objects fill it from the front and seen ones from the back, so each colour is one range
+/// and the whole field is drawn with two calls. the array keeps its storage from frame to frame.
+class OutlineBatch {
+public:
+	void Fill(const std::vector<Object *> &objects);
+
+	[[nodiscard]]
+	const std::vector<glm::vec2> &GetVertices() const { return vertices; }
+
+	/// hidden outlines are vertices [0, hidden_count)
+	[[nodiscard]]
+	int GetHiddenCount() const { return hidden_count; }
+
+	/// seen outlines are vertices [visible_start, vertex count)
+	[[nodiscard]]
+	int GetVisibleStart() const { return visible_start; }
+
+private:
+	/// the line from the center to the first corner shows the angle, then the ring
+	static int VertexCount(const Object &object) { return 2 * (object.GetSegments() + 1); }
+
+	std::vector<glm::vec2> vertices;
+	int hidden_count = 0;
+	int visible_start = 0;
+};
+
+void OutlineBatch::Fill(const std::vector<Object *> &objects) {
+	int total = 0;
+	for (auto object : objects) total += VertexCount(*object);
+	vertices.resize(total);
+
+	int front = 0, back = total;
+	for (auto object : objects) {
+		auto &shape = object->GetShape();
+		auto count = VertexCount(*object);
+		glm::vec2 *out;
+		if (object->visible) {
+			back -= count;
+			out = vertices.data() + back;
+		} else {
+			out = vertices.data() + front;
+			front += count;
+		}
+
+		auto previous = object->ToWorld(shape[1]);
+		*out++ = object->ToWorld(shape[0]);
+		*out++ = previous;
+		for (size_t i = 2; i < shape.size(); i++) {
+			auto next = object->ToWorld(shape[i]);
+			*out++ = previous;
+			*out++ = next;
+			previous = next;
+		}
+	}
+	hidden_count = front;
+	visible_start = back;
+}
@@ -1,21 +1,36 @@
+#pragma once
+
+#include <algorithm>
 #include <vector>
-#include <GL/glew.h>
 #include <glm/vec2.hpp>
 
+#include "EventSystem.hpp"
 #include "Object.hpp"
-
-class Scene {
+#include "ObserverBatch.hpp"
+#include "OutlineBatch.hpp"
+#include "SpatialGrid.hpp"
+#include "ThreadPool.hpp"
+#include "Visibility.hpp"
+
+/// after every update, observers get what came into or went out of view, for the player vision and
+/// for every agent in one batch, so their work follows the changes and not the object count
+class Scene : public EventSubject<VisibilityEvent> {
 public:
+	/// observer of the events of the player vision, agents are numbered from 0
+	static constexpr int VISION_OBSERVER = -1;
+
 	Scene() :
 			selected(-1),
 			vision_range(25),
 			vision_angle(60),
+			vision_fov(90),
 			vision_pos(0, 0) {}
 
 	void init();
 
 	void update(float dt);
 
+	/// legacy GL drawing, in SceneRender.hpp so the rest builds headless
 	void render();
 
 
@@ -33,20 +48,81 @@ public:
 
 	void Move(float x, float y, bool isRelative = false);
 
+	/// places any object, a transform write and no vertices until they are asked for
+	void MoveObject(int index, float x, float y);
+
 
 	void SetVisionPos(float x, float y) { vision_pos = glm::vec2(x, y); }
 
+	/// heading and full opening of the view cone in degrees
+	void SetVisionCone(float angle, float fov) {
+		vision_angle = angle;
+		vision_fov = fov;
+	}
+
+	void RotateVision(float angle) { vision_angle += angle; }
+
+	/// with occlusion the view cone is swept and objects hide what is behind them,
+	/// without it everything within the range circle is seen
+	void SetOcclusion(bool enabled) { occlusion = enabled; }
+
+	[[nodiscard]]
+	bool GetOcclusion() const { return occlusion; }
+
 
 	int AddObject(int segments, float radius, float angle, float x, float y);
 
 
+	/// objects the last update tested against the vision after the grid lookup
+	[[nodiscard]]
+	int GetTestedCount() const { return tested_count; }
+
+	[[nodiscard]]
+	const std::vector<int> &GetVisibleObjects() const { return visible_objects; }
+
+	/// area seen by the last update with occlusion, the observer then the outline
+	[[nodiscard]]
+	const std::vector<glm::vec2> &GetVisionPolygon() const { return vision_polygon; }
+
+
+	/// agents that see every update besides the player vision, returns the agent index
+	int AddAgent(const ViewCone &cone);
+
+	void SetAgent(int index, const ViewCone &cone) { agents[index] = cone; }
+
+	void RemoveAgents() { agents.clear(); }
+
+	[[nodiscard]]
+	const std::vector<ViewCone> &GetAgents() const { return agents; }
+
+	/// what every observer sees and what changed for it in the last update
+	[[nodiscard]]
+	const ObserverBatch &GetObserverBatch() const { return observer_batch; }
+
+
 private:
 	float vision_range;
 	float vision_angle;
+	float vision_fov;
 	glm::vec2 vision_pos;
+	bool occlusion = true;
 
 	std::vector<Object *> objects;
 	int selected;
+
+	SpatialGrid grid;
+	bool grid_dirty = true; // an object was added or moved since the last build
+	std::vector<int> visible_objects; // sorted
+	std::vector<int> previous_visible;
+	int tested_count = 0;
+	VisibilitySweep sweep;
+	std::vector<glm::vec2> vision_polygon;
+
+	ThreadPool pool;
+	std::vector<ViewCone> agents;
+	ObserverBatch observer_batch{&pool};
+
+	OutlineBatch outlines; // filled by render
 };
 
 void Scene::init() {
@@ -58,99 +134,63 @@ void Scene::init() {
 void Scene::update(float dt) {
 	// TODO update vision_pos
 
-	for (auto object : objects) {
-		object->visible = false;
-		for (auto v : object->vertices) {
-			if (glm::length(v - vision_pos) < vision_range) {
-				object->visible = true;
-				break;
-			}
-		}
+	if (grid_dirty) {
+		grid.Build(objects);
+		grid_dirty = false;
 	}
 
-}
-
-void drawPlus(float x, float y, float size) {
-	glBegin(GL_LINES);
-	glVertex2f(x - size, y);
-	glVertex2f(x + size, y);
-	glVertex2f(x, y - size);
-	glVertex2f(x, y + size);
-	glEnd();
-}
-
-void drawPoly(std::vector<glm::vec2> vertices) {
-	glBegin(GL_LINE_LOOP);
-	for (auto v : vertices)
-		glVertex2f(v.x, v.y);
-	glEnd();
-}
-
-void Scene::render() {
-	glPushAttrib(GL_LINE_BIT);
-
-	// Draw Origin
-	glColor3f(1, 0, 0);
-	drawPlus(0, 0, 20);
-
-//	// Draw Vision
-//	glColor3f(0, 1, 0);
-//	drawPlus(vision_pos.x, vision_pos.y, 5);
-
-	// draw field of view
-//	{
-//		auto rot = glm::rotate(glm::mat4(1), glm::radians(vision_angle), glm::vec3(0, 0, 1));
-//		auto pos0 = vision_pos;
-//		auto pos1 = pos0 + glm::vec2(rot * glm::vec4(vision_range, 0, 0, 1));
-//		auto pos2 = pos0 + glm::vec2(rot * glm::vec4(0, vision_range, 0, 1));
-//
-	glColor3f(0, 1, 1);
-	glLineWidth(2.0f);
-//		glBegin(GL_LINES);
-//		glVertex2f(pos0.x, pos0.y);
-//		glVertex2f(pos1.x, pos1.y);
-//		glVertex2f(pos0.x, pos0.y);
-//		glVertex2f(pos2.x, pos2.y);
-//		glEnd();
-//	}
-	drawPoly(CircleVertices(vision_range, vision_angle, vision_pos));
-
-
-	// Draw Box
-	for (auto object : this->objects) {
-		auto isVisible = object->visible;
-		auto vertices = object->vertices;
-
-		if (isVisible)
-			glColor3f(0, 0, 1);
-		else
-			glColor3f(1, 0, 0);
-		glLineWidth(2.0f);
-
-		drawPoly(vertices);
+	observer_batch.Update(agents, objects, grid);
+
+	std::swap(visible_objects, previous_visible);
+	visible_objects.clear();
+	if (occlusion) {
+		sweep.Compute(ViewCone{vision_pos, vision_angle, vision_range, vision_fov}, objects, grid, visible_objects, &vision_polygon);
+		tested_count = sweep.GetCandidateCount();
+	} else {
+		tested_count = 0;
+		grid.Query(vision_pos, vision_range, [this](int index) {
+			tested_count++;
+			if (InRange(*objects[index], vision_pos, vision_range)) visible_objects.push_back(index);
+		});
+		std::sort(visible_objects.begin(), visible_objects.end());
 	}
 
-	glPopAttrib();
+	// only what changed is flagged and sent
+	DiffVisible(previous_visible, visible_objects, [this](int index, bool visible) {
+		objects[index]->visible = visible;
+		QueueEvent(VisibilityEvent{VISION_OBSERVER, index, visible});
+	});
+	auto &agentEvents = observer_batch.GetEvents();
+	pending.insert(pending.end(), agentEvents.begin(), agentEvents.end());
+	FlushEvents();
 }
 
 int Scene::AddObject(int segments, float radius, float angle, float x, float y) {
-	auto obj = new Object{segments, radius, angle, glm::vec2(x, y)};
-	obj->GenerateVertices();
+	auto obj = new Object(segments, radius, angle, glm::vec2(x, y));
 	this->objects.push_back(obj);
+	grid_dirty = true;
 	return int(this->objects.size() - 1);
 }
 
+int Scene::AddAgent(const ViewCone &cone) {
+	agents.push_back(cone);
+	return int(agents.size() - 1);
+}
+
 void Scene::Select(int x, int y) {
 	auto p = glm::vec2(x, y);
+	if (grid_dirty) {
+		grid.Build(objects);
+		grid_dirty = false;
+	}
+
+	// lowest index under the point, like a front to back scan
 	selected = -1;
-	for (int i = 0; i < this->objects.size(); i++) {
+	grid.Query(p, 0, [&](int i) {
 		auto object = this->objects[i];
-		auto dist = glm::length(p - object->position);
-		if (dist < object->radius) {
-			selected = i;
-			return;
-		}
-	}
+		auto dist = glm::length(p - object->GetPosition());
+		if (dist < object->GetRadius() && (selected < 0 || i < selected)) selected = i;
+	});
 }
 
 void Scene::Select(int index) {
@@ -159,20 +199,20 @@ void Scene::Select(int index) {
 
 void Scene::Rotate(float angle, bool isRelative) {
 	if (selected >= 0) {
-		if (isRelative)
-			this->objects[selected]->angle += angle;
-		else
-			this->objects[selected]->angle = angle;
-		this->objects[selected]->GenerateVertices();
+		auto object = this->objects[selected];
+		object->SetAngle(isRelative ? object->GetAngle() + angle : angle);
 	}
 }
 
 void Scene::Move(float x, float y, bool isRelative) {
 	if (selected >= 0) {
-		if (isRelative)
-			this->objects[selected]->position += glm::vec2(x, y);
-		else
-			this->objects[selected]->position = glm::vec2(x, y);
-		this->objects[selected]->GenerateVertices();
+		auto object = this->objects[selected];
+		object->SetPosition(isRelative ? object->GetPosition() + glm::vec2(x, y) : glm::vec2(x, y));
+		grid_dirty = true;
 	}
 }
+
+void Scene::MoveObject(int index, float x, float y) {
+	this->objects[index]->SetPosition(glm::vec2(x, y));
+	grid_dirty = true;
+}
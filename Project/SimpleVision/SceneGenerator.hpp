@@ -0,0 +1,85 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include "Scene.hpp"
+
+enum FieldLayout {
+	/// evenly spread
+	FIELD_UNIFORM = 0,
+	/// gathered in groups with empty land between them
+	FIELD_CLUSTERED = 1,
+	/// blocks with open corridors running through them
+	FIELD_CORRIDOR = 2,
+};
+
+static const char *FIELD_LAYOUT_NAMES[] = {"uniform", "clustered", "corridor"};
+
+static const float FIELD_AREA_PER_OBJECT = 40;
+static const float CORRIDOR_SPACING = 60;
+static const float CORRIDOR_WIDTH = 16;
+static const int CORRIDOR_DRAWS = 100;
+
+/// side of the square a field of count objects covers, centered on the origin
+float FieldSize(int count) {
+	return std::sqrt(float(count) * FIELD_AREA_PER_OBJECT);
+}
+
+/// adds count objects in the layout, the same seed always gives the same field.
+/// shapes are drawn like the ones the game creates by mouse
+void GenerateField(Scene &scene, FieldLayout layout, int count, uint32_t seed) {
+	std::mt19937 random(seed);
+	const float half = FieldSize(count) / 2;
+	std::uniform_real_distribution<float> position(-half, half);
+	std::uniform_int_distribution<int> segments(3, 13);
+	std::uniform_real_distribution<float> radius(3, 13);
+	std::uniform_real_distribution<float> angle(0, 360);
+
+	std::vector<glm::vec2> clusters(layout == FIELD_CLUSTERED ? std::max(1, count / 250) : 0);
+	for (auto &center : clusters) center = glm::vec2(position(random), position(random)) * 0.9f;
+	std::uniform_int_distribution<int> cluster(0, std::max(0, int(clusters.size()) - 1));
+	std::normal_distribution<float> spread(0, 20);
+
+	for (int i = 0; i < count; i++) {
+		auto s = segments(random);
+		auto r = radius(random);
+		auto a = angle(random);
+		glm::vec2 p;
+		switch (layout) {
+			case FIELD_CLUSTERED:
+				p = clusters[cluster(random)] + glm::vec2(spread(random), spread(random));
+				break;
+			case FIELD_CORRIDOR:
+				// drawn again till the shape stays clear of the corridor it is closest to. a field smaller than
+				// a block may have no such place, then it goes midway between two corridors
+				for (int draw = 0;; draw++) {
+					p = glm::vec2(position(random), position(random));
+					if (std::fabs(p.y - std::round(p.y / CORRIDOR_SPACING) * CORRIDOR_SPACING) >= CORRIDOR_WIDTH / 2 + r) break;
+					if (draw == CORRIDOR_DRAWS) {
+						p.y = (std::floor(p.y / CORRIDOR_SPACING) + 0.5f) * CORRIDOR_SPACING;
+						break;
+					}
+				}
+				break;
+			default:
+				p = glm::vec2(position(random), position(random));
+				break;
+		}
+		scene.AddObject(s, r, a, p.x, p.y);
+	}
+}
+
+/// point t in [0, 1) of a closed walk through a field of count objects, for corridors it goes
+/// down the corridor through the origin and back, otherwise it is a circle around the center
+glm::vec2 FieldPath(FieldLayout layout, int count, float t) {
+	const float size = FieldSize(count);
+	if (layout == FIELD_CORRIDOR) return glm::vec2(size * 0.4f * (4 * std::fabs(t - 0.5f) - 1), 0);
+
+	const float angle = 2 * glm::pi<float>() * t;
+	return glm::vec2(std::cos(angle), std::sin(angle)) * (size / 4);
+}
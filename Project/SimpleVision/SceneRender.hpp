@@ -0,0 +1,94 @@
+#pragma once
+
+#include <vector>
+#include <GL/glew.h>
+#include <glm/vec2.hpp>
+
+#include "Scene.hpp"
+
+void drawPlus(float x, float y, float size) {
+	glBegin(GL_LINES);
+	glVertex2f(x - size, y);
+	glVertex2f(x + size, y);
+	glVertex2f(x, y - size);
+	glVertex2f(x, y + size);
+	glEnd();
+}
+
+void drawPoly(const std::vector<glm::vec2> &vertices) {
+	glBegin(GL_LINE_LOOP);
+	for (auto v : vertices)
+		glVertex2f(v.x, v.y);
+	glEnd();
+}
+
+/// the batch goes through one stream buffer, the old storage is dropped first so the driver does not
+/// wait for the frame still drawing from it
+void drawOutlines(const OutlineBatch &batch) {
+	static GLuint buffer = 0;
+	if (buffer == 0) glGenBuffers(1, &buffer);
+
+	auto &vertices = batch.GetVertices();
+	const auto size = GLsizeiptr(vertices.size() * sizeof(glm::vec2));
+	glBindBuffer(GL_ARRAY_BUFFER, buffer);
+	glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, size, vertices.data());
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glVertexPointer(2, GL_FLOAT, sizeof(glm::vec2), nullptr);
+
+	glColor3f(1, 0, 0);
+	glDrawArrays(GL_LINES, 0, batch.GetHiddenCount());
+	glColor3f(0, 0, 1);
+	glDrawArrays(GL_LINES, batch.GetVisibleStart(), GLsizei(vertices.size()) - batch.GetVisibleStart());
+
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void Scene::render() {
+	glPushAttrib(GL_LINE_BIT);
+
+	// Draw Origin
+	glColor3f(1, 0, 0);
+	drawPlus(0, 0, 20);
+
+//	// Draw Vision
+//	glColor3f(0, 1, 0);
+//	drawPlus(vision_pos.x, vision_pos.y, 5);
+
+	// draw field of view
+//	{
+//		auto rot = glm::rotate(glm::mat4(1), glm::radians(vision_angle), glm::vec3(0, 0, 1));
+//		auto pos0 = vision_pos;
+//		auto pos1 = pos0 + glm::vec2(rot * glm::vec4(vision_range, 0, 0, 1));
+//		auto pos2 = pos0 + glm::vec2(rot * glm::vec4(0, vision_range, 0, 1));
+//
+	glColor3f(0, 1, 1);
+	glLineWidth(2.0f);
+//		glBegin(GL_LINES);
+//		glVertex2f(pos0.x, pos0.y);
+//		glVertex2f(pos1.x, pos1.y);
+//		glVertex2f(pos0.x, pos0.y);
+//		glVertex2f(pos2.x, pos2.y);
+//		glEnd();
+//	}
+	if (occlusion)
+		drawPoly(vision_polygon);
+	else {
+		// the shared unit shape placed by the GL matrix
+		glPushMatrix();
+		glTranslatef(vision_pos.x, vision_pos.y, 0);
+		glRotatef(vision_angle, 0, 0, 1);
+		glScalef(vision_range, vision_range, 1);
+		drawPoly(UnitShape(10 + int(vision_range / 5)));
+		glPopMatrix();
+	}
+
+
+	// Draw Box
+	outlines.Fill(this->objects);
+	drawOutlines(outlines);
+
+	glPopAttrib();
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Object.hpp"
+
+/// uniform grid over the objects, rebuilt with one counting sort.
+/// every object is listed once, in the cell of its position, and queries grow their disc by the
+/// largest object radius, so a disc query visits only the cells under it and needs no duplicate check.
+class SpatialGrid {
+public:
+	static const int MAX_CELLS_PER_AXIS = 1024;
+
+	explicit SpatialGrid(float cell_size = 32) : cell_size(cell_size) {}
+
+	void Build(const std::vector<Object *> &objects);
+
+	/// calls fn(index) for every object whose bounding circle may overlap the disc
+	template<class Fn>
+	void Query(glm::vec2 center, float range, Fn fn) const;
+
+	[[nodiscard]]
+	int GetObjectCount() const { return int(cell_items.size()); }
+
+private:
+	[[nodiscard]]
+	glm::ivec2 CellOf(glm::vec2 p) const;
+
+	float cell_size;
+	float cell = 1; // cell_size, grown when the objects spread too far for MAX_CELLS_PER_AXIS
+	float max_radius = 0;
+	glm::vec2 origin = glm::vec2(0);
+	glm::ivec2 dims = glm::ivec2(0);
+
+	std::vector<int> cell_start; // objects of cell c are cell_items[cell_start[c] .. cell_start[c + 1]]
+	std::vector<int> cell_items;
+	std::vector<int> object_cell;
+};
+
+void SpatialGrid::Build(const std::vector<Object *> &objects) {
+	const auto n = int(objects.size());
+	cell_items.resize(n);
+	object_cell.resize(n);
+	if (n == 0) {
+		dims = glm::ivec2(0);
+		cell_start.assign(1, 0);
+		return;
+	}
+
+	auto lo = objects[0]->GetPosition(), hi = lo;
+	max_radius = 0;
+	for (auto object : objects) {
+		lo = glm::min(lo, object->GetPosition());
+		hi = glm::max(hi, object->GetPosition());
+		max_radius = std::max(max_radius, object->GetRadius());
+	}
+
+	origin = lo;
+	cell = std::max(cell_size, std::max(hi.x - lo.x, hi.y - lo.y) / float(MAX_CELLS_PER_AXIS - 1));
+	dims = glm::ivec2(int((hi.x - lo.x) / cell) + 1, int((hi.y - lo.y) / cell) + 1);
+
+	// counting sort by cell, the counts become cell ends and filling backwards turns them into cell starts
+	const auto cells = dims.x * dims.y;
+	cell_start.assign(cells + 1, 0);
+	for (int i = 0; i < n; i++) {
+		auto c = CellOf(objects[i]->GetPosition());
+		object_cell[i] = c.y * dims.x + c.x;
+		cell_start[object_cell[i]]++;
+	}
+	for (int c = 1; c < cells; c++) cell_start[c] += cell_start[c - 1];
+	cell_start[cells] = n;
+	for (int i = n - 1; i >= 0; i--) cell_items[--cell_start[object_cell[i]]] = i;
+}
+
+glm::ivec2 SpatialGrid::CellOf(glm::vec2 p) const {
+	return glm::ivec2(
+			std::clamp(int(std::floor((p.x - origin.x) / cell)), 0, dims.x - 1),
+			std::clamp(int(std::floor((p.y - origin.y) / cell)), 0, dims.y - 1));
+}
+
+template<class Fn>
+void SpatialGrid::Query(glm::vec2 center, float range, Fn fn) const {
+	if (dims.x == 0) return;
+
+	const auto reach = range + max_radius;
+	const auto lo = CellOf(center - glm::vec2(reach));
+	const auto hi = CellOf(center + glm::vec2(reach));
+
+	// the cells of one row are next to each other, so each row is one run of cell_items
+	for (int y = lo.y; y <= hi.y; y++) {
+		const auto first = cell_start[y * dims.x + lo.x];
+		const auto last = cell_start[y * dims.x + hi.x + 1];
+		for (int i = first; i < last; i++) fn(cell_items[i]);
+	}
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/// fixed set of worker threads for data parallel loops.
+/// the calling thread takes part in the work, so a pool of 0 workers simply runs inline.
+class ThreadPool {
+public:
+	/// workers == -1 uses one worker per hardware thread (besides the caller)
+	explicit ThreadPool(int workers = -1);
+
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool &) = delete;
+
+	ThreadPool &operator=(const ThreadPool &) = delete;
+
+	/// number of threads a loop is split over, including the caller
+	[[nodiscard]]
+	int GetThreadCount() const { return int(workers.size()) + 1; }
+
+	/// calls fn(begin, end) over [0, count) in chunks of grain, returns when all chunks are done
+	template<class Fn>
+	void ParallelFor(int count, int grain, Fn &&fn) {
+		using Task = std::remove_reference_t<Fn>;
+		Run(count, grain, [](void *context, int begin, int end) {
+			(*(Task *) context)(begin, end);
+		}, (void *) &fn);
+	}
+
+private:
+	void Run(int count, int grain, void (*task)(void *, int, int), void *context);
+
+	void Work();
+
+	void WorkerLoop();
+
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable start_condition;
+	std::condition_variable done_condition;
+
+	// current job
+	void (*task)(void *, int, int) = nullptr;
+	void *context = nullptr;
+	int count = 0;
+	int grain = 1;
+	std::atomic<int> next{0};
+	int busy_workers = 0;
+	unsigned int generation = 0;
+	bool stopping = false;
+};
+
+ThreadPool::ThreadPool(int worker_count) {
+	if (worker_count < 0)
+		worker_count = std::max(0, int(std::thread::hardware_concurrency()) - 1);
+
+	for (int i = 0; i < worker_count; i++)
+		workers.emplace_back(&ThreadPool::WorkerLoop, this);
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	start_condition.notify_all();
+	for (auto &worker : workers) worker.join();
+}
+
+void ThreadPool::Run(int job_count, int job_grain, void (*job_task)(void *, int, int), void *job_context) {
+	if (job_count <= 0) return;
+	job_grain = std::max(1, job_grain);
+
+	// not worth waking anyone up
+	if (workers.empty() || job_count <= job_grain) {
+		job_task(job_context, 0, job_count);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		task = job_task;
+		context = job_context;
+		count = job_count;
+		grain = job_grain;
+		next = 0;
+		busy_workers = int(workers.size());
+		generation++;
+	}
+	start_condition.notify_all();
+
+	Work();
+
+	std::unique_lock<std::mutex> lock(mutex);
+	done_condition.wait(lock, [this]() { return busy_workers == 0; });
+}
+
+void ThreadPool::Work() {
+	for (int begin; (begin = next.fetch_add(grain)) < count;)
+		task(context, begin, std::min(count, begin + grain));
+}
+
+void ThreadPool::WorkerLoop() {
+	unsigned int seen_generation = 0;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			start_condition.wait(lock, [&]() { return stopping || generation != seen_generation; });
+			if (stopping) return;
+			seen_generation = generation;
+		}
+
+		Work();
+
+		std::lock_guard<std::mutex> lock(mutex);
+		if (--busy_workers == 0) done_condition.notify_one();
+	}
+}
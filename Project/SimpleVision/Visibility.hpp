@@ -0,0 +1,312 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include "Object.hpp"
+#include "SpatialGrid.hpp"
+
+/// what one observer can see, angles in degrees like Object::angle
+struct ViewCone {
+	glm::vec2 position;
+	float heading; // center of the cone
+	float range;
+	float fov; // full opening angle, 360 for all around
+};
+
+/// line of sight inside a view cone with objects hiding what is behind them.
+/// the outline edges facing the observer are swept in angle order, between two edge end points the nearest
+/// edge is the visible surface, which gives the visibility polygon and the visible objects.
+/// the active edges are a bitset in order of their closest distance, so an edge comes and goes in O(1) and
+/// a probe stops at the first edge that can not beat its best hit. sorting is O(n log n), a probe costs the
+/// active edges nearer than its hit, which is all of them only when many edges sit at about the same distance.
+/// an interval whose ends disagree has crossing edges in it and is halved till the ends of every piece agree.
+/// all buffers are kept between calls, one sweep per thread can answer many observers without allocating.
+class VisibilitySweep {
+public:
+	/// degrees between the points of an unblocked arc of the polygon
+	static constexpr float ARC_STEP = 10;
+
+	/// radians below which an interval with disagreeing ends is not halved any more
+	static constexpr float MIN_SPLIT = 1e-4f;
+
+	/// fills visible with the sorted indices of the seen objects, and polygon with the visible area
+	/// (observer first, then the outline in angle order) when it is not null
+	void Compute(const ViewCone &cone, const std::vector<Object *> &objects, const SpatialGrid &grid,
+	             std::vector<int> &visible, std::vector<glm::vec2> *polygon = nullptr);
+
+	/// objects the grid handed to the last Compute
+	[[nodiscard]]
+	int GetCandidateCount() const { return candidate_count; }
+
+	/// edges swept by the last Compute
+	[[nodiscard]]
+	int GetEdgeCount() const { return int(edges.size()); }
+
+private:
+	struct Edge {
+		glm::vec2 a, b;
+		float closest; // distance from the observer to the nearest point of the edge
+		int object;
+	};
+
+	struct Event {
+		float angle; // from the cone start
+		int edge;
+		bool add;
+
+		bool operator<(const Event &other) const { return angle < other.angle; }
+	};
+
+	void AddEdge(glm::vec2 a, glm::vec2 b, int object);
+
+	void AddSpan(float start, float end, int edge);
+
+	/// distance along the ray from the observer in direction dir to the edge
+	[[nodiscard]]
+	float Hit(int edge, glm::vec2 dir) const;
+
+	/// nearest active edge at this angle and its distance, -1 when the ray is open
+	int Nearest(float angle, float &distance) const;
+
+	void Activate(int edge, bool add);
+
+	/// probes inside (from, to) in angle order till the nearest edges at the ends of every piece agree
+	template<class Emit>
+	void Split(float from, int fromEdge, float to, int toEdge, Emit &emit) const;
+
+	ViewCone view{};
+	float start = 0; // radians of the cone start
+	float fov = 0; // radians
+	int candidate_count = 0;
+
+	std::vector<Edge> edges;
+	std::vector<Event> events;
+	std::vector<int> by_closest; // edge indices in order of closest
+	std::vector<int> rank; // place of each edge in by_closest
+	std::vector<uint64_t> active_bits; // one bit per rank
+	std::vector<uint64_t> active_words; // one bit per non empty word of active_bits
+	int active_count = 0;
+	std::vector<glm::vec2> ring; // world outline of the object being added
+};
+
+/// angle wrapped into [0, 2pi)
+float WrapAngle(float angle) {
+	const auto turn = 2 * glm::pi<float>();
+	angle = std::fmod(angle, turn);
+	return angle < 0 ? angle + turn : angle;
+}
+
+void VisibilitySweep::Compute(const ViewCone &cone, const std::vector<Object *> &objects, const SpatialGrid &grid,
+                              std::vector<int> &visible, std::vector<glm::vec2> *polygon) {
+	const auto turn = 2 * glm::pi<float>();
+	view = cone;
+	fov = std::min(glm::radians(cone.fov), turn);
+	start = glm::radians(cone.heading) - fov / 2;
+
+	edges.clear();
+	events.clear();
+	visible.clear();
+	candidate_count = 0;
+
+	// candidates, bounding circle against range and cone, then the outline edges facing the observer
+	grid.Query(cone.position, cone.range, [&](int index) {
+		candidate_count++;
+		auto object = objects[index];
+		const auto d = object->GetPosition() - cone.position;
+		const auto dist = glm::length(d);
+		const auto radius = object->GetRadius();
+		if (dist >= cone.range + radius) return;
+		if (dist > radius && fov < turn) {
+			const auto half = std::asin(radius / dist);
+			const auto from = WrapAngle(std::atan2(d.y, d.x) - half - start);
+			if (from > fov && from + 2 * half < turn) return;
+		}
+
+		// the ring after the center vertex of the shape is closed, its last vertex repeats the first
+		auto &shape = object->GetShape();
+		ring.resize(shape.size() - 1);
+		for (size_t i = 1; i < shape.size(); i++) ring[i - 1] = object->ToWorld(shape[i]);
+
+		if (dist <= radius) {
+			// the observer may stand inside, an enclosing outline faces away and is seen from within
+			bool inside = true;
+			for (size_t i = 0; i + 1 < ring.size() && inside; i++) {
+				auto e = ring[i + 1] - ring[i];
+				auto p = cone.position - ring[i];
+				inside = e.x * p.y - e.y * p.x >= 0;
+			}
+			if (inside) {
+				visible.push_back(index);
+				return;
+			}
+		}
+
+		for (size_t i = 0; i + 1 < ring.size(); i++) {
+			auto a = ring[i], b = ring[i + 1];
+			auto e = b - a;
+			auto p = cone.position - a;
+			if (e.x * p.y - e.y * p.x < 0) AddEdge(a, b, index); // counter clockwise ring, observer on the right
+		}
+	});
+
+	std::sort(events.begin(), events.end());
+
+	by_closest.resize(edges.size());
+	for (size_t i = 0; i < edges.size(); i++) by_closest[i] = int(i);
+	std::sort(by_closest.begin(), by_closest.end(), [this](int a, int b) { return edges[a].closest < edges[b].closest; });
+	rank.resize(edges.size());
+	for (size_t i = 0; i < by_closest.size(); i++) rank[by_closest[i]] = int(i);
+	active_bits.assign((edges.size() + 63) / 64, 0);
+	active_words.assign((active_bits.size() + 63) / 64, 0);
+	active_count = 0;
+
+	if (polygon != nullptr) {
+		polygon->clear();
+		polygon->push_back(cone.position);
+	}
+	auto addPoint = [&](float angle, float distance) {
+		auto a = start + angle;
+		polygon->push_back(cone.position + glm::vec2(std::cos(a), std::sin(a)) * distance);
+	};
+	auto emit = [&](float angle, int edge, float distance) {
+		if (edge >= 0 && distance < cone.range) visible.push_back(edges[edge].object);
+		if (polygon != nullptr) addPoint(angle, edge >= 0 ? std::min(distance, cone.range) : cone.range);
+	};
+
+	// sweep, the active edges between two event angles do not change
+	float angle = 0;
+	size_t e = 0;
+	while (true) {
+		for (; e < events.size() && events[e].angle <= angle; e++) Activate(events[e].edge, events[e].add);
+
+		const auto next = e < events.size() ? events[e].angle : fov;
+		if (next > angle) {
+			if (active_count == 0) {
+				// an open arc at full range
+				if (polygon != nullptr) {
+					const auto step = glm::radians(ARC_STEP);
+					for (float a = angle; a < next; a += step) addPoint(a, cone.range);
+					addPoint(next, cone.range);
+				}
+			} else {
+				float fromDistance, toDistance;
+				auto from = Nearest(angle, fromDistance);
+				auto to = Nearest(next, toDistance);
+				emit(angle, from, fromDistance);
+				Split(angle, from, next, to, emit);
+				emit(next, to, toDistance);
+			}
+		}
+		if (e >= events.size() || next >= fov) break;
+		angle = next;
+	}
+
+	std::sort(visible.begin(), visible.end());
+	visible.erase(std::unique(visible.begin(), visible.end()), visible.end());
+}
+
+void VisibilitySweep::AddEdge(glm::vec2 a, glm::vec2 b, int object) {
+	const auto turn = 2 * glm::pi<float>();
+
+	// only the part inside the range can be seen, clipped the edge comes in and out at its end points
+	// instead of between two probes that both miss it
+	const auto ab = b - a;
+	const auto ap = a - view.position;
+	const auto half = glm::dot(ap, ab) / glm::dot(ab, ab);
+	const auto root = half * half - (glm::dot(ap, ap) - view.range * view.range) / glm::dot(ab, ab);
+	if (root <= 0) return;
+	const auto from = std::max(-half - std::sqrt(root), 0.0f), to = std::min(-half + std::sqrt(root), 1.0f);
+	if (from >= to) return;
+	b = a + ab * to;
+	a = a + ab * from;
+
+	auto ra = WrapAngle(std::atan2(a.y - view.position.y, a.x - view.position.x) - start);
+	auto rb = WrapAngle(std::atan2(b.y - view.position.y, b.x - view.position.x) - start);
+
+	// a facing edge runs clockwise from a to b, so it spans less than half a turn counter clockwise from b
+	auto span = ra - rb;
+	if (span < 0) span += turn;
+	if (span <= 0 || span >= glm::pi<float>()) return;
+
+	// nearest point of the segment for skipping edges that can not beat the best hit
+	const auto t = std::clamp(-half, from, to);
+	const auto closest = glm::length(ap + ab * t);
+
+	const auto edge = int(edges.size());
+	edges.push_back(Edge{a, b, closest, object});
+	if (rb + span > turn) {
+		AddSpan(rb, turn, edge);
+		AddSpan(0, rb + span - turn, edge);
+	} else {
+		AddSpan(rb, rb + span, edge);
+	}
+}
+
+void VisibilitySweep::AddSpan(float from, float to, int edge) {
+	from = std::max(from, 0.0f);
+	to = std::min(to, fov);
+	if (from >= to) return;
+	events.push_back(Event{from, edge, true});
+	events.push_back(Event{to, edge, false});
+}
+
+float VisibilitySweep::Hit(int edge, glm::vec2 dir) const {
+	const auto &e = edges[edge];
+	const auto ab = e.b - e.a;
+	const auto ap = e.a - view.position;
+	const auto denominator = dir.x * ab.y - dir.y * ab.x;
+	if (std::fabs(denominator) < 1e-12f) return std::min(glm::length(ap), glm::length(e.b - view.position));
+	return std::max(0.0f, (ap.x * ab.y - ap.y * ab.x) / denominator);
+}
+
+int VisibilitySweep::Nearest(float angle, float &distance) const {
+	const auto a = start + angle;
+	const auto dir = glm::vec2(std::cos(a), std::sin(a));
+	int nearest = -1;
+	distance = 0;
+	for (size_t s = 0; s < active_words.size(); s++) {
+		for (auto summary = active_words[s]; summary != 0; summary &= summary - 1) {
+			const auto w = s * 64 + std::countr_zero(summary);
+			for (auto bits = active_bits[w]; bits != 0; bits &= bits - 1) {
+				const auto edge = by_closest[w * 64 + std::countr_zero(bits)];
+				// every edge after this one starts even further away
+				if (nearest >= 0 && edges[edge].closest >= distance) return nearest;
+				auto d = Hit(edge, dir);
+				if (nearest < 0 || d < distance) {
+					nearest = edge;
+					distance = d;
+				}
+			}
+		}
+	}
+	return nearest;
+}
+
+void VisibilitySweep::Activate(int edge, bool add) {
+	const auto r = rank[edge];
+	auto &word = active_bits[r / 64];
+	const auto bit = uint64_t(1) << (r % 64);
+	if (add == ((word & bit) != 0)) return;
+	word ^= bit;
+	active_count += add ? 1 : -1;
+	const auto summaryBit = uint64_t(1) << (r / 64 % 64);
+	if (word != 0) active_words[r / 4096] |= summaryBit;
+	else active_words[r / 4096] &= ~summaryBit;
+}
+
+template<class Emit>
+void VisibilitySweep::Split(float from, int fromEdge, float to, int toEdge, Emit &emit) const {
+	if (fromEdge == toEdge || to - from < MIN_SPLIT) return;
+	const auto middle = (from + to) / 2;
+	float distance;
+	auto edge = Nearest(middle, distance);
+	Split(from, fromEdge, middle, edge, emit);
+	emit(middle, edge, distance);
+	Split(middle, edge, to, toEdge, emit);
+}